@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+# Build and run the DSP benchmark (tests/spacecho_bench.c)
+#
+# Native by default (x86 or ARM host): builds with the release optimization
+# flags and runs it. Set CROSS_PREFIX to cross-compile for the Move instead;
+# copy build/spacecho_bench to the device and run it there. When qemu-aarch64
+# is installed the tests are cross-built too and run under it first, so the
+# NEON kernels are checked off-device (the x86 build only runs plain C).
+#
+# Usage: ./scripts/bench.sh [seconds per configuration]
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+REPO_ROOT="$(dirname "$SCRIPT_DIR")"
+
+cd "$REPO_ROOT"
+mkdir -p build
+
+if [ -n "$CROSS_PREFIX" ]; then
+    if command -v qemu-aarch64 >/dev/null 2>&1; then
+        echo "Running tests under qemu-aarch64..."
+        for test in tests/*_test.c; do
+            name="$(basename "$test" .c)"
+            ${CROSS_PREFIX}gcc -Ofast -static \
+                -march=armv8-a -mtune=cortex-a72 \
+                -DNDEBUG \
+                "$test" \
+                -o "build/$name" \
+                -Isrc/dsp \
+                -lm -lpthread
+            qemu-aarch64 "build/$name" || { echo "FAIL: $name (aarch64)"; exit 1; }
+        done
+    fi
+
+    echo "Cross-compiling benchmark ($CROSS_PREFIX)..."
+    ${CROSS_PREFIX}gcc -Ofast \
+        -march=armv8-a -mtune=cortex-a72 \
+        -fomit-frame-pointer -fno-stack-protector \
+        -DNDEBUG \
+        tests/spacecho_bench.c \
+        -o build/spacecho_bench \
+        -Isrc/dsp \
+        -lm -lpthread
+    echo "Built: build/spacecho_bench (copy to the Move and run)"
+    exit 0
+fi
+
+echo "Building benchmark (native)..."
+${CC:-gcc} -Ofast \
+    -fomit-frame-pointer -fno-stack-protector \
+    -DNDEBUG \
+    tests/spacecho_bench.c \
+    -o build/spacecho_bench \
+    -Isrc/dsp \
+    -lm -lpthread
+
+./build/spacecho_bench "$@"
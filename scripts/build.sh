@@ -56,7 +56,7 @@ ${CROSS_PREFIX}gcc -Ofast -shared -fPIC \
     src/dsp/spacecho.c \
     -o build/tapedelay.so \
     -Isrc/dsp \
-    -lm
+    -lm -lpthread
 
 # Copy files to dist (use cat to avoid ExtFS deallocation issues with Docker)
 echo "Packaging..."
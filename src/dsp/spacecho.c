@@ -2,21 +2,39 @@
  * TapeDelay Audio FX Plugin - Tape Delay
  *
  * Based on https://github.com/cyrusasfa/TapeDelay
- * Simple, clean tape delay with linear interpolation and smooth parameter ramping
+ * Simple, clean tape delay with selectable fractional interpolation and smooth parameter ramping
  *
  * V2 API only - instance-based for multi-instance support.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  /* pthread_setaffinity_np, CPU_SET */
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SPACECHO_HAVE_NEON 1
+#endif
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
 #include "audio_fx_api_v1.h"
 
-#define SAMPLE_RATE 44100.0f
 #define MAX_DELAY_SECONDS 2.0f
+#define MIN_DELAY_SECONDS 0.02f
 
 /* ============================================================================
  * SMOOTHED VALUE - For click-free parameter changes
@@ -59,40 +77,502 @@ static float SmoothedValue_GetNext(SmoothedValue *sv) {
     return sv->currentValue;
 }
 
+/* Advance n samples without producing values */
+static void SmoothedValue_Advance(SmoothedValue *sv, int n) {
+    if (sv->stepsRemaining <= 0) return;
+    if (n >= sv->stepsRemaining) {
+        sv->currentValue = sv->targetValue;
+        sv->stepsRemaining = 0;
+    } else {
+        sv->currentValue += sv->step * (float)n;
+        sv->stepsRemaining -= n;
+    }
+}
+
+static int SmoothedValue_IsSettledAt(const SmoothedValue *sv, float value) {
+    return sv->stepsRemaining == 0 && sv->currentValue == value;
+}
+
+/* Fill dst with the next n values (same sequence as n GetNext calls) */
+static void SmoothedValue_Fill(SmoothedValue *sv, float *dst, int n) {
+    int i = 0;
+    while (i < n && sv->stepsRemaining > 0) {
+        dst[i++] = SmoothedValue_GetNext(sv);
+    }
+    for (; i < n; i++) {
+        dst[i] = sv->currentValue;
+    }
+}
+
+/* ============================================================================
+ * ENUM OPTIONS - Labels of the enum params, parsed and listed from one table
+ *
+ * Each enum's labels are written once, as a FOO_OPTIONS(FIRST, NEXT) list
+ * that expands into both the foo_names array (OPTION_NAME) and the
+ * chain_params options array (OPTIONS_JSON), so the two cannot drift apart.
+ * ============================================================================ */
+
+#define OPTION_NAME(label) label,
+#define OPTION_JSON_FIRST(label) #label
+#define OPTION_JSON_NEXT(label) "," #label
+#define OPTIONS_JSON(list) "[" list(OPTION_JSON_FIRST, OPTION_JSON_NEXT) "]"
+#define OPTION_COUNT(names) ((int)(sizeof(names) / sizeof((names)[0])))
+
+/* Enum value from a label (JS shadow UI) or an option index (C chain_host
+ * sends "0", "1", ...; clamped). Labels are tried first, since "1/4" would
+ * parse as a number. Anything else is option 0. */
+static int parse_option(const char *val, const char *const *names, int count) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(val, names[i]) == 0) return i;
+    }
+    char *endptr;
+    long idx = strtol(val, &endptr, 10);
+    if (endptr != val && *endptr == '\0') {
+        if (idx < 0) idx = 0;
+        if (idx >= count) idx = count - 1;
+        return (int)idx;
+    }
+    return 0;
+}
+
 /* ============================================================================
- * DELAY LINE - Circular buffer with linear interpolation
+ * STEREO DELAY LINE - Interleaved L/R circular buffer with fractional interpolation
+ *
+ * Both channels share one buffer of [L0, R0, L1, R1, ...] pairs, so one
+ * position/wrap computation and one cache line serve both channels.
+ *
+ * The length is rounded up to a power of two. Positions wrap with a mask,
+ * and read positions are 32-bit fixed-point phases with fracBits fractional
+ * bits chosen so that bufferLength << fracBits == 2^32: the phase wraps by
+ * plain unsigned overflow and index/fraction come from a shift and a mask.
+ *
+ * The "quality" param picks the interpolator: linear (2 frames), 4-point
+ * Hermite, first-order allpass (flat magnitude, one state per head; best
+ * for slowly moving delays) or an 8-tap polyphase windowed sinc.
+ *
+ * Samples are floats by default. The compact storage modes keep 16 bits per
+ * sample instead (half the footprint and bandwidth, with lo-fi character):
+ * int16 fixed point over +-DELAY_INT16_RANGE, or bf16 (the top half of the
+ * float: full range, 8-bit mantissa). Writes round to nearest; reads decode
+ * the frames an interpolator reaches into a small float window.
  * ============================================================================ */
 
+typedef enum {
+    INTERP_LINEAR = 0,
+    INTERP_HERMITE,
+    INTERP_ALLPASS,
+    INTERP_SINC,
+    INTERP_COUNT
+} InterpMode;
+
+#define INTERP_OPTIONS(FIRST, NEXT) FIRST("linear") NEXT("hermite") NEXT("allpass") NEXT("sinc")
+
+static const char *interp_names[] = { INTERP_OPTIONS(OPTION_NAME, OPTION_NAME) };
+
+_Static_assert(OPTION_COUNT(interp_names) == INTERP_COUNT, "one label per InterpMode");
+
+#define QUALITY_OPTIONS_JSON OPTIONS_JSON(INTERP_OPTIONS)
+
+#define SINC_TAPS 8
+#define SINC_PHASE_BITS 8
+#define SINC_PHASES (1 << SINC_PHASE_BITS)
+#define SINC_CUTOFF 0.9f          /* fraction of Nyquist, tames imaging near fs/2 */
+#define INTERP_LOOKAHEAD (SINC_TAPS / 2)  /* frames past index0 the widest kernel reads */
+
+/* Row p holds the taps for fraction p / SINC_PHASES (one extra row for 1.0) */
+static float g_sinc_table[SINC_PHASES + 1][SINC_TAPS];
+static pthread_once_t g_sinc_table_once = PTHREAD_ONCE_INIT;
+
+static void sinc_table_build(void) {
+    const double pi = 3.14159265358979323846;
+    const double half = SINC_TAPS / 2;
+    for (int p = 0; p <= SINC_PHASES; p++) {
+        double fraction = (double)p / SINC_PHASES;
+        double sum = 0.0;
+        double taps[SINC_TAPS];
+        for (int k = 0; k < SINC_TAPS; k++) {
+            /* Tap k sits at index0 - (SINC_TAPS/2 - 1) + k */
+            double x = (double)(k - (SINC_TAPS / 2 - 1)) - fraction;
+            double arg = pi * SINC_CUTOFF * x;
+            double sinc = fabs(x) < 1e-9 ? SINC_CUTOFF : SINC_CUTOFF * sin(arg) / arg;
+            double window = fabs(x) >= half ? 0.0 :
+                            0.42 + 0.5 * cos(pi * x / half) + 0.08 * cos(2.0 * pi * x / half);
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+        for (int k = 0; k < SINC_TAPS; k++) {
+            g_sinc_table[p][k] = (float)(taps[k] / sum);  /* unity DC gain per phase */
+        }
+    }
+}
+
+/* Any thread: build the sinc table on first use; concurrent creates wait for it */
+static void sinc_table_init(void) {
+    pthread_once(&g_sinc_table_once, sinc_table_build);
+}
+
+typedef enum {
+    DELAY_STORAGE_FLOAT = 0,
+    DELAY_STORAGE_INT16,
+    DELAY_STORAGE_BF16,
+    DELAY_STORAGE_COUNT
+} DelayStorage;
+
+static const char *delay_storage_names[] = { "float", "int16", "bf16" };
+
+#define DELAY_INT16_RANGE 4.0f  /* int16 full scale: 12dB of headroom for the feedback loop */
+#define DELAY_INT16_SCALE (32767.0f / DELAY_INT16_RANGE)
+#define DELAY_INT16_UNSCALE (DELAY_INT16_RANGE / 32767.0f)
+
+/* Bytes per interleaved L/R frame */
+static inline size_t delay_storage_frame_bytes(int storage) {
+    return storage == DELAY_STORAGE_FLOAT ? 2 * sizeof(float) : 2 * sizeof(uint16_t);
+}
+
+static inline uint16_t delay_pack(int storage, float x) {
+    if (storage == DELAY_STORAGE_INT16) {
+        float scaled = fminf(fmaxf(x * DELAY_INT16_SCALE, -32767.0f), 32767.0f);
+        return (uint16_t)(int16_t)lrintf(scaled);
+    }
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return (uint16_t)((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);  /* nearest, ties to even */
+}
+
+static inline float delay_unpack(int storage, uint16_t v) {
+    if (storage == DELAY_STORAGE_INT16) return (float)(int16_t)v * DELAY_INT16_UNSCALE;
+    uint32_t bits = (uint32_t)v << 16;
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
 typedef struct {
-    float *buffer;
-    int bufferLength;
-    int writePosition;
+    float *buffer;      /* bufferLength interleaved L/R frames (float storage) */
+    uint16_t *packed;   /* the same layout in compact storage, NULL for float */
+    int storage;        /* DelayStorage */
+    int bufferLength;   /* in frames, power of two */
+    int writePosition;  /* in frames, always written & mask */
+    uint32_t written;   /* frames written since creation, wraps */
     float sampleRate;
-} DelayLine;
 
-static void DelayLine_Init(DelayLine *dl, float sampleRate) {
+    /* Fixed-point addressing */
+    uint32_t mask;       /* bufferLength - 1 */
+    int fracBits;        /* 32 - log2(bufferLength) */
+    uint32_t fracMask;   /* (1 << fracBits) - 1 */
+    float phaseScale;    /* 2^fracBits */
+    float fracScale;     /* 2^-fracBits */
+
+    int interpolation;   /* InterpMode, shared by every read head */
+} StereoDelayLine;
+
+/* Buffer length in frames that reaches a delay of 'seconds' at sampleRate
+ * (interpolator taps included), power of two */
+static int StereoDelayLine_LengthFor(float seconds, float sampleRate) {
+    int needed = (int)(seconds * sampleRate) + 1 + INTERP_LOOKAHEAD;
+    int length = 2;
+    while (length < needed) {
+        length <<= 1;
+    }
+    return length;
+}
+
+/* Point the line at a buffer of 'length' frames and derive the addressing */
+static void StereoDelayLine_SetBuffer(StereoDelayLine *dl, void *buffer, int length) {
+    int log2Length = 1;
+    while ((1 << log2Length) < length) {
+        log2Length++;
+    }
+
+    dl->bufferLength = length;
+    dl->buffer = dl->storage == DELAY_STORAGE_FLOAT ? (float *)buffer : NULL;
+    dl->packed = dl->storage == DELAY_STORAGE_FLOAT ? NULL : (uint16_t *)buffer;
+
+    dl->mask = (uint32_t)length - 1;
+    dl->fracBits = 32 - log2Length;
+    dl->fracMask = (1u << dl->fracBits) - 1;
+    dl->phaseScale = ldexpf(1.0f, dl->fracBits);
+    dl->fracScale = ldexpf(1.0f, -dl->fracBits);
+}
+
+/* buffer must hold 'length' zeroed frames of delay_storage_frame_bytes(storage),
+ * length a power of two */
+static void StereoDelayLine_Init(StereoDelayLine *dl, float sampleRate, void *buffer, int length, int storage) {
     dl->sampleRate = sampleRate;
-    dl->bufferLength = (int)(MAX_DELAY_SECONDS * sampleRate);
-    dl->buffer = (float *)calloc(dl->bufferLength, sizeof(float));
+    dl->storage = storage;
     dl->writePosition = 0;
+    dl->written = 0;
+    dl->interpolation = INTERP_LINEAR;
+    StereoDelayLine_SetBuffer(dl, buffer, length);
+}
+
+/* Copy the frames with write counts [from, from + count) between buffers that
+ * keep frame c at index c & mask, splitting at either wrap */
+static void delay_copy_frames(void *dst, uint32_t dstMask, const void *src, uint32_t srcMask,
+                              uint32_t from, uint32_t count, size_t frameBytes) {
+    while (count > 0) {
+        uint32_t d = from & dstMask, s = from & srcMask;
+        uint32_t span = count;
+        if (span > dstMask + 1 - d) span = dstMask + 1 - d;
+        if (span > srcMask + 1 - s) span = srcMask + 1 - s;
+        memcpy((uint8_t *)dst + d * frameBytes, (const uint8_t *)src + s * frameBytes, span * frameBytes);
+        from += span;
+        count -= span;
+    }
+}
+
+/* Zero the frames with write counts [from, from + count) of such a buffer */
+static void delay_zero_frames(void *dst, uint32_t mask, uint32_t from, uint32_t count, size_t frameBytes) {
+    while (count > 0) {
+        uint32_t d = from & mask;
+        uint32_t span = count < mask + 1 - d ? count : mask + 1 - d;
+        memset((uint8_t *)dst + d * frameBytes, 0, span * frameBytes);
+        from += span;
+        count -= span;
+    }
+}
+
+/* Oldest frames of the history a copy made off the audio thread leaves out.
+ * The audio thread overwrites those slots first, so the copy never reads a
+ * slot while it is written unless it stalls for this many frames. */
+#define DELAY_GROW_GUARD_FRAMES 4096
+
+static uint32_t delay_grow_guard(uint32_t oldLength) {
+    return oldLength < DELAY_GROW_GUARD_FRAMES ? oldLength : DELAY_GROW_GUARD_FRAMES;
+}
+
+/* Switch to a longer buffer that already holds the history up to write count
+ * 'copied', minus its oldest delay_grow_guard frames (see DelayGrowth_Reserve).
+ * Frames written since are copied again, the guard frames still in the window
+ * are copied, and the slots of frames that left the window meanwhile are
+ * cleared, so every frame keeps its distance from the write head and
+ * distances past the old length read as silence. Returns 0, leaving the line
+ * as it was, when more than a buffer length was written since the copy. */
+static int StereoDelayLine_Grow(StereoDelayLine *dl, void *buffer, int length, uint32_t copied) {
+    const size_t frameBytes = delay_storage_frame_bytes(dl->storage);
+    const void *old = dl->packed ? (const void *)dl->packed : (const void *)dl->buffer;
+    const uint32_t since = dl->written - copied;
+    const uint32_t oldLength = (uint32_t)dl->bufferLength;
+    const uint32_t guard = delay_grow_guard(oldLength);
+    const uint32_t mask = (uint32_t)length - 1;
+    if (since > oldLength) return 0;
+    if (since < guard) {
+        delay_copy_frames(buffer, mask, old, dl->mask, dl->written - oldLength, guard - since, frameBytes);
+    } else {
+        delay_zero_frames(buffer, mask, copied - oldLength + guard, since - guard, frameBytes);
+    }
+    delay_copy_frames(buffer, mask, old, dl->mask, copied, since, frameBytes);
+    StereoDelayLine_SetBuffer(dl, buffer, length);
+    dl->writePosition = (int)(dl->written & dl->mask);
+    return 1;
+}
+
+static void StereoDelayLine_Write(StereoDelayLine *dl, float left, float right) {
+    if (dl->packed) {
+        dl->packed[dl->writePosition * 2] = delay_pack(dl->storage, left);
+        dl->packed[dl->writePosition * 2 + 1] = delay_pack(dl->storage, right);
+    } else {
+        dl->buffer[dl->writePosition * 2] = left;
+        dl->buffer[dl->writePosition * 2 + 1] = right;
+    }
+    dl->writePosition = (dl->writePosition + 1) & dl->mask;
+    dl->written++;
+}
+
+/* Fixed-point phase of the write head, 'offset' frames ahead */
+static inline uint32_t StereoDelayLine_WritePhase(const StereoDelayLine *dl, int offset) {
+    return (uint32_t)((dl->writePosition + offset) & dl->mask) << dl->fracBits;
+}
+
+/* Fixed-point distance for a delay in samples, clamped to [1, bufferLength - 1] */
+static inline uint32_t StereoDelayLine_DelayToPhase(const StereoDelayLine *dl, float delaySamples) {
+    delaySamples = fminf(fmaxf(delaySamples, 1.0f), (float)(dl->bufferLength - 1));
+    return (uint32_t)(delaySamples * dl->phaseScale);
+}
+
+/* Frames around index0 each interpolator reads: first offset and count */
+static const int8_t interp_reach[INTERP_COUNT][2] = {
+    [INTERP_LINEAR] = { 0, 2 },
+    [INTERP_HERMITE] = { -1, 4 },
+    [INTERP_ALLPASS] = { 0, 3 },
+    [INTERP_SINC] = { -(SINC_TAPS / 2 - 1), SINC_TAPS },
+};
+
+#define INTERP_WINDOW SINC_TAPS  /* widest reach, power of two */
+
+/* Compact storage: decode the frames an interpolator at index0 reads into win
+ * (interleaved floats, addressed with mask INTERP_WINDOW - 1); returns index0
+ * within the window */
+static inline uint32_t StereoDelayLine_Unpack(const StereoDelayLine *dl, uint32_t index0, float *win) {
+    const int first = interp_reach[dl->interpolation][0], count = interp_reach[dl->interpolation][1];
+    for (int k = 0; k < count; k++) {
+        const uint16_t *p = dl->packed + ((index0 + (uint32_t)(first + k)) & dl->mask) * 2;
+        win[k * 2] = delay_unpack(dl->storage, p[0]);
+        win[k * 2 + 1] = delay_unpack(dl->storage, p[1]);
+    }
+    return (uint32_t)-first;
+}
+
+/* Interpolate both channels between index0 and index0 + 1 of float frames */
+static inline void delay_interpolate(const float *buf, uint32_t mask, int interpolation, uint32_t index0,
+                                     float fraction, float *state, float *outL, float *outR) {
+    switch (interpolation) {
+    case INTERP_HERMITE: {
+        const float *xm1 = buf + ((index0 - 1) & mask) * 2;
+        const float *x0 = buf + index0 * 2;
+        const float *x1 = buf + ((index0 + 1) & mask) * 2;
+        const float *x2 = buf + ((index0 + 2) & mask) * 2;
+        float out[2];
+        for (int ch = 0; ch < 2; ch++) {
+            float c1 = 0.5f * (x1[ch] - xm1[ch]);
+            float c2 = xm1[ch] - 2.5f * x0[ch] + 2.0f * x1[ch] - 0.5f * x2[ch];
+            float c3 = 0.5f * (x2[ch] - xm1[ch]) + 1.5f * (x0[ch] - x1[ch]);
+            out[ch] = ((c3 * fraction + c2) * fraction + c1) * fraction + x0[ch];
+        }
+        *outL = out[0];
+        *outR = out[1];
+        break;
+    }
+    case INTERP_ALLPASS: {
+        /* Delay behind the newer frame, kept in [0.5, 1.5) so the pole stays well inside */
+        float delta = 1.0f - fraction;
+        uint32_t newer = index0 + 1;
+        if (delta < 0.5f) {
+            delta += 1.0f;
+            newer++;
+        }
+        float eta = (1.0f - delta) / (1.0f + delta);
+        const float *xn = buf + (newer & mask) * 2;
+        const float *xo = buf + ((newer - 1) & mask) * 2;
+        state[0] = eta * (xn[0] - state[0]) + xo[0];
+        state[1] = eta * (xn[1] - state[1]) + xo[1];
+        *outL = state[0];
+        *outR = state[1];
+        break;
+    }
+    case INTERP_SINC: {
+        /* Blend the two nearest phases so the response moves smoothly with the fraction */
+        float position = fraction * SINC_PHASES;
+        int row = (int)position;
+        if (row > SINC_PHASES - 1) row = SINC_PHASES - 1;  /* fraction may round up to 1.0 */
+        float blend = position - (float)row;
+        const float *h0 = g_sinc_table[row], *h1 = g_sinc_table[row + 1];
+        uint32_t first = index0 - (SINC_TAPS / 2 - 1);
+        float accL = 0.0f, accR = 0.0f;
+        for (int k = 0; k < SINC_TAPS; k++) {
+            const float *x = buf + ((first + k) & mask) * 2;
+            float h = h0[k] + blend * (h1[k] - h0[k]);
+            accL += h * x[0];
+            accR += h * x[1];
+        }
+        *outL = accL;
+        *outR = accR;
+        break;
+    }
+    default: {
+        const float *p0 = buf + index0 * 2;
+        const float *p1 = buf + ((index0 + 1) & mask) * 2;
+        *outL = p0[0] + fraction * (p1[0] - p0[0]);
+        *outR = p0[1] + fraction * (p1[1] - p0[1]);
+        break;
+    }
+    }
+}
+
+/* Interpolate both channels between index0 and index0 + 1 with the selected
+ * mode. state holds the allpass head's previous L/R output (unused otherwise). */
+static inline void StereoDelayLine_Interpolate(const StereoDelayLine *dl, uint32_t index0, float fraction,
+                                               float *state, float *outL, float *outR) {
+    if (dl->packed) {
+        float win[INTERP_WINDOW * 2];
+        uint32_t at = StereoDelayLine_Unpack(dl, index0, win);
+        delay_interpolate(win, INTERP_WINDOW - 1, dl->interpolation, at, fraction, state, outL, outR);
+        return;
+    }
+    delay_interpolate(dl->buffer, dl->mask, dl->interpolation, index0, fraction, state, outL, outR);
+}
+
+/* Interpolated read of both channels at a fixed-point phase */
+static inline void StereoDelayLine_ReadPhase(const StereoDelayLine *dl, uint32_t phase, float *state,
+                                             float *outL, float *outR) {
+    float fraction = (float)(phase & dl->fracMask) * dl->fracScale;
+    StereoDelayLine_Interpolate(dl, phase >> dl->fracBits, fraction, state, outL, outR);
 }
 
-static void DelayLine_Free(DelayLine *dl) {
-    if (dl->buffer) {
-        free(dl->buffer);
-        dl->buffer = NULL;
+#ifdef SPACECHO_HAVE_NEON
+/* delay_interpolate with L/R in the two lanes of one vector */
+static inline float32x2_t delay_interpolate_neon(const float *buf, uint32_t mask, int interpolation,
+                                                 uint32_t index0, float fraction, float *state) {
+    switch (interpolation) {
+    case INTERP_HERMITE: {
+        float32x2_t xm1 = vld1_f32(buf + ((index0 - 1) & mask) * 2);
+        float32x2_t x0 = vld1_f32(buf + index0 * 2);
+        float32x2_t x1 = vld1_f32(buf + ((index0 + 1) & mask) * 2);
+        float32x2_t x2 = vld1_f32(buf + ((index0 + 2) & mask) * 2);
+        float32x2_t c1 = vmul_n_f32(vsub_f32(x1, xm1), 0.5f);
+        float32x2_t c2 = vsub_f32(vadd_f32(xm1, vmul_n_f32(x1, 2.0f)),
+                                  vadd_f32(vmul_n_f32(x0, 2.5f), vmul_n_f32(x2, 0.5f)));
+        float32x2_t c3 = vadd_f32(vmul_n_f32(vsub_f32(x2, xm1), 0.5f), vmul_n_f32(vsub_f32(x0, x1), 1.5f));
+        float32x2_t y = vmla_n_f32(c2, c3, fraction);
+        y = vmla_n_f32(c1, y, fraction);
+        return vmla_n_f32(x0, y, fraction);
+    }
+    case INTERP_ALLPASS: {
+        float delta = 1.0f - fraction;
+        uint32_t newer = index0 + 1;
+        if (delta < 0.5f) {
+            delta += 1.0f;
+            newer++;
+        }
+        float eta = (1.0f - delta) / (1.0f + delta);
+        float32x2_t xn = vld1_f32(buf + (newer & mask) * 2);
+        float32x2_t xo = vld1_f32(buf + ((newer - 1) & mask) * 2);
+        float32x2_t y = vmla_n_f32(xo, vsub_f32(xn, vld1_f32(state)), eta);
+        vst1_f32(state, y);
+        return y;
+    }
+    case INTERP_SINC: {
+        float position = fraction * SINC_PHASES;
+        int row = (int)position;
+        if (row > SINC_PHASES - 1) row = SINC_PHASES - 1;  /* fraction may round up to 1.0 */
+        float blend = position - (float)row;
+        float h[SINC_TAPS];
+        for (int k = 0; k < SINC_TAPS; k += 4) {
+            float32x4_t h0 = vld1q_f32(g_sinc_table[row] + k);
+            float32x4_t h1 = vld1q_f32(g_sinc_table[row + 1] + k);
+            vst1q_f32(h + k, vmlaq_n_f32(h0, vsubq_f32(h1, h0), blend));
+        }
+        uint32_t first = index0 - (SINC_TAPS / 2 - 1);
+        float32x2_t acc = vdup_n_f32(0.0f);
+        for (int k = 0; k < SINC_TAPS; k++) {
+            acc = vmla_n_f32(acc, vld1_f32(buf + ((first + k) & mask) * 2), h[k]);
+        }
+        return acc;
+    }
+    default: {
+        float32x2_t p0 = vld1_f32(buf + index0 * 2);
+        float32x2_t p1 = vld1_f32(buf + ((index0 + 1) & mask) * 2);
+        return vadd_f32(p0, vmul_n_f32(vsub_f32(p1, p0), fraction));
+    }
     }
 }
 
-static void DelayLine_Write(DelayLine *dl, float sample) {
-    dl->buffer[dl->writePosition] = sample;
-    dl->writePosition++;
-    if (dl->writePosition >= dl->bufferLength) {
-        dl->writePosition = 0;
+/* StereoDelayLine_Interpolate with L/R in the two lanes of one vector */
+static inline float32x2_t StereoDelayLine_InterpolateNeon(const StereoDelayLine *dl, uint32_t index0,
+                                                          float fraction, float *state) {
+    if (dl->packed) {
+        float win[INTERP_WINDOW * 2];
+        uint32_t at = StereoDelayLine_Unpack(dl, index0, win);
+        return delay_interpolate_neon(win, INTERP_WINDOW - 1, dl->interpolation, at, fraction, state);
     }
+    return delay_interpolate_neon(dl->buffer, dl->mask, dl->interpolation, index0, fraction, state);
 }
+#endif
 
-static float DelayLine_Read(DelayLine *dl, float delayTimeSeconds) {
+/* Resolve a fractional delay into the two frames to interpolate between.
+ * Float/modulo addressing of the original DelayLine, used by the reference kernel. */
+static float StereoDelayLine_Locate(const StereoDelayLine *dl, int writePos, float delayTimeSeconds,
+                                    int *index0, int *index1) {
     /* Calculate read position with fractional sample */
     float delaySamples = delayTimeSeconds * dl->sampleRate;
 
@@ -100,18 +580,160 @@ static float DelayLine_Read(DelayLine *dl, float delayTimeSeconds) {
     if (delaySamples < 1.0f) delaySamples = 1.0f;
     if (delaySamples > dl->bufferLength - 1) delaySamples = dl->bufferLength - 1;
 
-    float readPos = (float)dl->writePosition - delaySamples;
+    float readPos = (float)writePos - delaySamples;
     if (readPos < 0) readPos += dl->bufferLength;
+    if (readPos >= dl->bufferLength) readPos = 0.0f;  /* a tiny negative wrapped and rounded up to the length */
+
+    *index0 = (int)floorf(readPos);
+    *index1 = (*index0 + 1) % dl->bufferLength;
+    return readPos - floorf(readPos);
+}
+
+/* Read both channels relative to an explicit write position */
+static void StereoDelayLine_ReadFrom(const StereoDelayLine *dl, int writePos, float delayTimeSeconds,
+                                     float *state, float *outL, float *outR) {
+    int index0, index1;
+    float fraction = StereoDelayLine_Locate(dl, writePos, delayTimeSeconds, &index0, &index1);
+    StereoDelayLine_Interpolate(dl, (uint32_t)index0, fraction, state, outL, outR);
+}
+
+static void StereoDelayLine_Read(const StereoDelayLine *dl, float delayTimeSeconds,
+                                 float *state, float *outL, float *outR) {
+    StereoDelayLine_ReadFrom(dl, dl->writePosition, delayTimeSeconds, state, outL, outR);
+}
+
+/* Decode and deinterleave n compact frames into l/r */
+static void delay_unpack_frames(int storage, const uint16_t *src, float *l, float *r, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    if (storage == DELAY_STORAGE_INT16) {
+        for (; i + 4 <= n; i += 4) {
+            int16x4x2_t lr = vld2_s16((const int16_t *)src + i * 2);
+            vst1q_f32(l + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(lr.val[0])), DELAY_INT16_UNSCALE));
+            vst1q_f32(r + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(lr.val[1])), DELAY_INT16_UNSCALE));
+        }
+    } else {
+        for (; i + 4 <= n; i += 4) {
+            uint16x4x2_t lr = vld2_u16(src + i * 2);
+            vst1q_f32(l + i, vreinterpretq_f32_u32(vshll_n_u16(lr.val[0], 16)));
+            vst1q_f32(r + i, vreinterpretq_f32_u32(vshll_n_u16(lr.val[1], 16)));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        l[i] = delay_unpack(storage, src[i * 2]);
+        r[i] = delay_unpack(storage, src[i * 2 + 1]);
+    }
+}
+
+#ifdef SPACECHO_HAVE_NEON
+/* delay_pack for four samples */
+static inline uint16x4_t delay_pack_neon(int storage, float32x4_t x) {
+    if (storage == DELAY_STORAGE_INT16) {
+        float32x4_t scaled = vmulq_n_f32(x, DELAY_INT16_SCALE);
+        scaled = vminq_f32(vmaxq_f32(scaled, vdupq_n_f32(-32767.0f)), vdupq_n_f32(32767.0f));
+        return vreinterpret_u16_s16(vqmovn_s32(vcvtnq_s32_f32(scaled)));
+    }
+    uint32x4_t bits = vreinterpretq_u32_f32(x);
+    uint32x4_t lsb = vandq_u32(vshrq_n_u32(bits, 16), vdupq_n_u32(1));
+    return vshrn_n_u32(vaddq_u32(vaddq_u32(bits, vdupq_n_u32(0x7FFF)), lsb), 16);
+}
+#endif
+
+/* Encode and interleave n frames from l/r into compact storage */
+static void delay_pack_frames(int storage, uint16_t *dst, const float *l, const float *r, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 4 <= n; i += 4) {
+        uint16x4x2_t v;
+        v.val[0] = delay_pack_neon(storage, vld1q_f32(l + i));
+        v.val[1] = delay_pack_neon(storage, vld1q_f32(r + i));
+        vst2_u16(dst + i * 2, v);
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i * 2] = delay_pack(storage, l[i]);
+        dst[i * 2 + 1] = delay_pack(storage, r[i]);
+    }
+}
 
-    /* Linear interpolation */
-    float fraction = readPos - floorf(readPos);
-    int index0 = (int)floorf(readPos);
-    int index1 = (index0 + 1) % dl->bufferLength;
+/* Deinterleave n consecutive frames from index0 on into l/r, splitting at the wrap point */
+static void StereoDelayLine_CopyFrames(const StereoDelayLine *dl, uint32_t index0, float *l, float *r, int n) {
+    int done = 0;
+    while (done < n) {
+        int start = (int)((index0 + (uint32_t)done) & dl->mask);
+        int span = dl->bufferLength - start;
+        if (span > n - done) span = n - done;
+        if (dl->packed) {
+            delay_unpack_frames(dl->storage, dl->packed + start * 2, l + done, r + done, span);
+            done += span;
+            continue;
+        }
+        const float *src = dl->buffer + start * 2;
+        float *dstL = l + done, *dstR = r + done;
+        int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+        for (; i + 4 <= span; i += 4) {
+            float32x4x2_t lr = vld2q_f32(src + i * 2);
+            vst1q_f32(dstL + i, lr.val[0]);
+            vst1q_f32(dstR + i, lr.val[1]);
+        }
+#endif
+        for (; i < span; i++) {
+            dstL[i] = src[i * 2];
+            dstR[i] = src[i * 2 + 1];
+        }
+        done += span;
+    }
+}
 
-    float sample0 = dl->buffer[index0];
-    float sample1 = dl->buffer[index1];
+/* Write n frames of silence, splitting at the wrap point */
+static void StereoDelayLine_WriteSilence(StereoDelayLine *dl, int n) {
+    int done = 0;
+    while (done < n) {
+        int span = dl->bufferLength - dl->writePosition;
+        if (span > n - done) span = n - done;
+        /* both compact formats encode 0.0f as all-zero bits */
+        uint8_t *base = dl->packed ? (uint8_t *)dl->packed : (uint8_t *)dl->buffer;
+        const size_t frameBytes = delay_storage_frame_bytes(dl->storage);
+        memset(base + dl->writePosition * frameBytes, 0, (size_t)span * frameBytes);
+        done += span;
+        dl->writePosition = (dl->writePosition + span) & dl->mask;
+    }
+    dl->written += (uint32_t)n;
+}
 
-    return sample0 + fraction * (sample1 - sample0);
+/* Interleave and write n consecutive frames, splitting at the wrap point */
+static void StereoDelayLine_WriteBlock(StereoDelayLine *dl, const float *left, const float *right, int n) {
+    int done = 0;
+    while (done < n) {
+        int span = dl->bufferLength - dl->writePosition;
+        if (span > n - done) span = n - done;
+        if (dl->packed) {
+            delay_pack_frames(dl->storage, dl->packed + dl->writePosition * 2, left + done, right + done, span);
+            done += span;
+            dl->writePosition = (dl->writePosition + span) & dl->mask;
+            continue;
+        }
+        float *dst = dl->buffer + dl->writePosition * 2;
+        const float *l = left + done, *r = right + done;
+        int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+        for (; i + 4 <= span; i += 4) {
+            float32x4x2_t v;
+            v.val[0] = vld1q_f32(l + i);
+            v.val[1] = vld1q_f32(r + i);
+            vst2q_f32(dst + i * 2, v);
+        }
+#endif
+        for (; i < span; i++) {
+            dst[i * 2] = l[i];
+            dst[i * 2 + 1] = r[i];
+        }
+        done += span;
+        dl->writePosition = (dl->writePosition + span) & dl->mask;
+    }
+    dl->written += (uint32_t)n;
 }
 
 /* ============================================================================
@@ -136,304 +758,4356 @@ static void OnePoleFilter_SetCutoff(OnePoleFilter *f, float cutoffHz, float samp
     f->a0 = 1.0f - f->b1;
 }
 
+/* Set the pole directly (b1 from a ToneTable), unity DC gain */
+static inline void OnePoleFilter_SetPole(OnePoleFilter *f, float b1) {
+    f->b1 = b1;
+    f->a0 = 1.0f - b1;
+}
+
 static float OnePoleFilter_Process(OnePoleFilter *f, float input) {
     f->z1 = input * f->a0 + f->z1 * f->b1;
     return f->z1;
 }
 
 /* ============================================================================
- * SHARED STATE
+ * SOFT SATURATION - Rational tanh approximation on the feedback write
+ *
+ * tanh(x) ~ x * (27 + x^2) / (27 + 9x^2), exact at 0, reaching 1 with zero
+ * slope at |x| = 3 (clamped beyond), within 0.025 of tanh everywhere. The
+ * stage computes tanh(g*x)/g: unity gain for quiet signals, a ceiling of
+ * 1/g for loud ones, so drive lowers the level the repeats compress at.
  * ============================================================================ */
 
-#define MAX_CHANNELS 2
-#define RAMP_SAMPLES 2205
-#define CLOCKS_PER_QUARTER 24  /* MIDI standard: 24 PPQN */
+#define SATURATION_KNEE 3.0f
 
-static const host_api_v1_t *g_host = NULL;
+static inline float SoftClip(float x, float gain) {
+    float t = x * gain;
+    if (t > SATURATION_KNEE) t = SATURATION_KNEE;
+    if (t < -SATURATION_KNEE) t = -SATURATION_KNEE;
+    float t2 = t * t;
+    return t * (27.0f + t2) / (gain * (27.0f + 9.0f * t2));
+}
 
-static void plugin_log(const char *msg) {
-    if (g_host && g_host->log) {
-        char buf[256];
-        snprintf(buf, sizeof(buf), "[tapedelay] %s", msg);
-        g_host->log(buf);
+/* SoftClip in place; gains is a per-sample gain plane, or NULL for a constant gain */
+static void SoftClip_Block(float *x, const float *gains, float gain, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    const float32x4_t knee = vdupq_n_f32(SATURATION_KNEE), c27 = vdupq_n_f32(27.0f), c9 = vdupq_n_f32(9.0f);
+    float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= n; i += 4) {
+        if (gains) g = vld1q_f32(gains + i);
+        float32x4_t t = vmulq_f32(vld1q_f32(x + i), g);
+        t = vminq_f32(vmaxq_f32(t, vnegq_f32(knee)), knee);
+        float32x4_t t2 = vmulq_f32(t, t);
+        float32x4_t num = vmulq_f32(t, vaddq_f32(c27, t2));
+        float32x4_t den = vmulq_f32(g, vaddq_f32(c27, vmulq_f32(c9, t2)));
+        vst1q_f32(x + i, vdivq_f32(num, den));
+    }
+#endif
+    for (; i < n; i++) {
+        x[i] = SoftClip(x[i], gains ? gains[i] : gain);
     }
 }
 
-/* Convert milliseconds to seconds */
-static float GetDelayTimeSeconds(int ms) {
-    /* Clamp to valid range */
-    if (ms < 20) ms = 20;
-    if (ms > 2000) ms = 2000;
-    return (float)ms / 1000.0f;
-}
+/* ============================================================================
+ * HALF-BAND - Polyphase 2x FIR up/downsampling around the saturation
+ *
+ * Linear-phase half-band lowpass of length 4K-1 (Kaiser-windowed sinc). Its
+ * even taps vanish apart from the 0.5 centre, so a 2x stage evaluates only
+ * the K symmetric odd-tap pairs per base sample, split by phase with no zero
+ * stuffing. 4x cascades a second, shorter stage. Up and down together delay
+ * by 2K samples at the stage's lower rate, which lengthens the feedback loop
+ * slightly (24 samples at 2x, 28 at 4x).
+ * ============================================================================ */
 
-static float GetFeedback(float normalized) {
-    /* 0-1 maps to 0-0.95 */
-    return normalized * 0.95f;
-}
+#define HALFBAND_MAX_TAPS 12                           /* K of the base-rate stage */
+#define HALFBAND_HISTORY (2 * HALFBAND_MAX_TAPS - 1)   /* inputs kept between calls */
+#define HALFBAND_KAISER_BETA 6.0                       /* ~ -65dB stopband */
 
-static float GetToneFrequency(float normalized) {
-    /* 0-1 maps to 500Hz-12000Hz (exponential) */
-    return 500.0f * powf(24.0f, normalized);
+typedef enum {
+    OVERSAMPLING_OFF = 0,
+    OVERSAMPLING_2X,
+    OVERSAMPLING_4X,
+    OVERSAMPLING_COUNT
+} Oversampling;
+
+#define OVERSAMPLING_OPTIONS(FIRST, NEXT) FIRST("off") NEXT("2x") NEXT("4x")
+
+static const char *oversampling_names[] = { OVERSAMPLING_OPTIONS(OPTION_NAME, OPTION_NAME) };
+
+_Static_assert(OPTION_COUNT(oversampling_names) == OVERSAMPLING_COUNT, "one label per Oversampling");
+
+#define OVERSAMPLING_OPTIONS_JSON OPTIONS_JSON(OVERSAMPLING_OPTIONS)
+
+typedef struct {
+    int taps;                        /* K: odd-tap pairs */
+    float coeff[HALFBAND_MAX_TAPS];  /* c_k = h[2k+1] = h[-(2k+1)] */
+} HalfBand;
+
+typedef struct {
+    float up[HALFBAND_HISTORY];        /* upsampler inputs */
+    float downEven[HALFBAND_HISTORY];  /* downsampler even / odd phase inputs */
+    float downOdd[HALFBAND_HISTORY + 1];
+} HalfBandState;
+
+static HalfBand g_halfband[2];  /* [0] base <-> 2x, [1] 2x <-> 4x */
+static pthread_once_t g_halfband_once = PTHREAD_ONCE_INIT;
+
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
 }
 
-static float GetStereoWidth(int percent) {
-    if (percent < 0) percent = 0;
-    if (percent > 100) percent = 100;
-    return (float)percent / 100.0f;
+static void HalfBand_Design(HalfBand *hb, int taps) {
+    const double pi = 3.14159265358979323846;
+    const double half = 2.0 * taps - 1.0;  /* outermost tap */
+    double sum = 0.0;
+    double c[HALFBAND_MAX_TAPS];
+    hb->taps = taps;
+    for (int k = 0; k < taps; k++) {
+        double m = 2.0 * k + 1.0;
+        double r = m / half;
+        double window = bessel_i0(HALFBAND_KAISER_BETA * sqrt(1.0 - r * r)) / bessel_i0(HALFBAND_KAISER_BETA);
+        c[k] = sin(0.5 * pi * m) / (pi * m) * window;
+        sum += c[k];
+    }
+    for (int k = 0; k < taps; k++) {
+        hb->coeff[k] = (float)(0.25 * c[k] / sum);  /* 0.5 centre + 2*sum = unity DC gain */
+    }
 }
 
-/* ============================================================================
- * TEMPO SYNC - Musical division to delay time
- * ============================================================================ */
+static void halfband_build(void) {
+    HalfBand_Design(&g_halfband[0], HALFBAND_MAX_TAPS);
+    HalfBand_Design(&g_halfband[1], 4);  /* audio band is only the lowest eighth at 4x */
+}
 
-enum {
-    DIV_FREE = 0,
-    DIV_1_1,
-    DIV_1_2,
-    DIV_1_2D,
-    DIV_1_4,
-    DIV_1_4D,
-    DIV_1_4T,
-    DIV_1_8,
-    DIV_1_8D,
-    DIV_1_8T,
-    DIV_1_16,
-    DIV_1_16T,
-    DIV_COUNT
-};
+/* Any thread: design the half-band filters on first use; concurrent creates wait for it */
+static void halfband_init(void) {
+    pthread_once(&g_halfband_once, halfband_build);
+}
 
-static const char *division_names[] = {
-    "free", "1/1", "1/2", "1/2d", "1/4", "1/4d", "1/4t",
-    "1/8", "1/8d", "1/8t", "1/16", "1/16t"
-};
+/* x holds 2K-1 history inputs then n new ones; pair sum for each new input */
+static inline float HalfBand_PairSum(const HalfBand *hb, const float *x, int i) {
+    const int K = hb->taps;
+    float acc = 0.0f;
+    for (int k = 0; k < K; k++) {
+        acc += hb->coeff[k] * (x[i + K - 1 - k] + x[i + K + k]);
+    }
+    return acc;
+}
 
-static const float division_multipliers[] = {
-    0.0f,      /* free - unused */
-    4.0f,      /* 1/1  = whole note */
-    2.0f,      /* 1/2  = half note */
-    3.0f,      /* 1/2d = dotted half */
-    1.0f,      /* 1/4  = quarter note */
-    1.5f,      /* 1/4d = dotted quarter */
-    0.66667f,  /* 1/4t = quarter triplet */
-    0.5f,      /* 1/8  = eighth note */
-    0.75f,     /* 1/8d = dotted eighth */
-    0.33333f,  /* 1/8t = eighth triplet */
-    0.25f,     /* 1/16 = sixteenth */
-    0.16667f   /* 1/16t = sixteenth triplet */
-};
+#ifdef SPACECHO_HAVE_NEON
+static inline float32x4_t HalfBand_PairSum4(const HalfBand *hb, const float *x, int i) {
+    const int K = hb->taps;
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (int k = 0; k < K; k++) {
+        float32x4_t pair = vaddq_f32(vld1q_f32(x + i + K - 1 - k), vld1q_f32(x + i + K + k));
+        acc = vaddq_f32(acc, vmulq_n_f32(pair, hb->coeff[k]));
+    }
+    return acc;
+}
+#endif
 
-/* Parse enum value - handles both string label (from JS shadow UI) and integer index (from C chain_host) */
-static int parse_division(const char *val) {
-    /* Try string match first (labels like "1/4" would confuse strtof) */
-    for (int i = 0; i < DIV_COUNT; i++) {
-        if (strcmp(val, division_names[i]) == 0) return i;
+/* n inputs -> 2n outputs, delayed K samples; work holds HALFBAND_HISTORY + n floats */
+static void HalfBand_Up(const HalfBand *hb, float *hist, const float *in, float *out, float *work, int n) {
+    const int H = 2 * hb->taps - 1, K = hb->taps;
+    memcpy(work, hist, (size_t)H * sizeof(float));
+    memcpy(work + H, in, (size_t)n * sizeof(float));
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 4 <= n; i += 4) {
+        float32x4x2_t v;
+        v.val[0] = vld1q_f32(work + i + K - 1);
+        v.val[1] = vmulq_n_f32(HalfBand_PairSum4(hb, work, i), 2.0f);
+        vst2q_f32(out + 2 * i, v);
     }
-    /* Fall back to numeric index (C chain_host sends "0", "1", etc.) */
-    char *endptr;
-    long idx = strtol(val, &endptr, 10);
-    if (endptr != val && *endptr == '\0') {
-        if (idx < 0) idx = 0;
-        if (idx >= DIV_COUNT) idx = DIV_COUNT - 1;
-        return (int)idx;
+#endif
+    for (; i < n; i++) {
+        out[2 * i] = work[i + K - 1];
+        out[2 * i + 1] = 2.0f * HalfBand_PairSum(hb, work, i);
     }
-    return DIV_FREE;
+    memcpy(hist, work + n, (size_t)H * sizeof(float));
 }
 
-/* Compute delay time in ms from BPM and division, clamped to 20-2000ms */
-static int compute_synced_time(int bpm, int division) {
-    if (division <= DIV_FREE || division >= DIV_COUNT) return -1;
-    float beat_ms = 60000.0f / (float)bpm;
-    float ms = division_multipliers[division] * beat_ms;
-    int result = (int)(ms + 0.5f);
-    if (result < 20) result = 20;
-    if (result > 2000) result = 2000;
-    return result;
+/*
+ * 2n inputs -> n outputs, delayed K samples so the pair adds no fraction.
+ * The centre tap lands on the even phase and the pairs on the odd phase, one
+ * input further back, so the odd side keeps one extra history sample.
+ * workEven / workOdd hold HALFBAND_HISTORY + 1 + n floats each.
+ */
+static void HalfBand_Down(const HalfBand *hb, float *histEven, float *histOdd, const float *in, float *out,
+                          float *workEven, float *workOdd, int n) {
+    const int H = 2 * hb->taps - 1, K = hb->taps;
+    memcpy(workEven, histEven, (size_t)H * sizeof(float));
+    memcpy(workOdd, histOdd, (size_t)(H + 1) * sizeof(float));
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 4 <= n; i += 4) {
+        float32x4x2_t v = vld2q_f32(in + 2 * i);
+        vst1q_f32(workEven + H + i, v.val[0]);
+        vst1q_f32(workOdd + H + 1 + i, v.val[1]);
+    }
+#endif
+    for (; i < n; i++) {
+        workEven[H + i] = in[2 * i];
+        workOdd[H + 1 + i] = in[2 * i + 1];
+    }
+    i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t centre = vmulq_n_f32(vld1q_f32(workEven + i + K - 1), 0.5f);
+        vst1q_f32(out + i, vaddq_f32(centre, HalfBand_PairSum4(hb, workOdd, i)));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = 0.5f * workEven[i + K - 1] + HalfBand_PairSum(hb, workOdd, i);
+    }
+    memcpy(histEven, workEven + n, (size_t)H * sizeof(float));
+    memcpy(histOdd, workOdd + n, (size_t)(H + 1) * sizeof(float));
 }
 
 /* ============================================================================
- * V2 API - Instance-based
+ * FLUTTER LFO - Table-driven tape flutter and wow at control rate
+ *
+ * Three sines (flutter, scrape flutter, wow) are looked up from a shared
+ * wavetable once every LFO_CONTROL_INTERVAL samples; the delay offset is
+ * linearly interpolated between control points, so the per-sample cost is one
+ * add. The same stepping drives both the per-sample and block paths.
  * ============================================================================ */
 
-#define AUDIO_FX_API_VERSION_2 2
+#define LFO_TABLE_BITS 8
+#define LFO_TABLE_SIZE (1 << LFO_TABLE_BITS)
+#define LFO_FRAC_BITS (32 - LFO_TABLE_BITS)
+#define LFO_CONTROL_INTERVAL 32      /* samples between control points */
 
-typedef struct audio_fx_api_v2 {
-    uint32_t api_version;
-    void* (*create_instance)(const char *module_dir, const char *config_json);
-    void (*destroy_instance)(void *instance);
-    void (*process_block)(void *instance, int16_t *audio_inout, int frames);
+#define FLUTTER_RATE_HZ 5.0f
+#define SCRAPE_RATE_HZ 7.7f
+#define WOW_RATE_HZ 0.55f
+#define SCRAPE_LEVEL 0.35f           /* relative to the main flutter sine */
+#define MAX_FLUTTER_SECONDS 0.00025f /* ~0.16% pitch deviation at 5Hz */
+#define MAX_WOW_SECONDS 0.002f       /* ~0.7% pitch deviation at 0.55Hz */
+#define MAX_MODULATION_SECONDS (MAX_FLUTTER_SECONDS + MAX_WOW_SECONDS)
+
+enum { LFO_FLUTTER = 0, LFO_SCRAPE, LFO_WOW, LFO_COUNT };
+
+static float g_lfo_table[LFO_TABLE_SIZE + 1];  /* one guard point for interpolation */
+static pthread_once_t g_lfo_table_once = PTHREAD_ONCE_INIT;
+
+static void lfo_table_build(void) {
+    for (int i = 0; i <= LFO_TABLE_SIZE; i++) {
+        g_lfo_table[i] = sinf(2.0f * 3.14159265f * (float)i / (float)LFO_TABLE_SIZE);
+    }
+}
+
+/* Any thread: build the LFO sine table on first use; concurrent creates wait for it */
+static void lfo_table_init(void) {
+    pthread_once(&g_lfo_table_once, lfo_table_build);
+}
+
+static inline float lfo_sine(uint32_t phase) {
+    uint32_t index = phase >> LFO_FRAC_BITS;
+    float fraction = (float)(phase & ((1u << LFO_FRAC_BITS) - 1)) * (1.0f / (float)(1u << LFO_FRAC_BITS));
+    return g_lfo_table[index] + fraction * (g_lfo_table[index + 1] - g_lfo_table[index]);
+}
+
+typedef struct {
+    uint32_t phase[LFO_COUNT];
+    uint32_t increment[LFO_COUNT];  /* per control point */
+    float flutterDepth;             /* seconds */
+    float wowDepth;                 /* seconds */
+    float value;                    /* current delay offset, seconds */
+    float slope;                    /* per-sample step toward the next control point */
+    int countdown;                  /* samples left in the current segment */
+} FlutterLFO;
+
+static void FlutterLFO_Init(FlutterLFO *lfo, float sampleRate) {
+    const float rates[LFO_COUNT] = { FLUTTER_RATE_HZ, SCRAPE_RATE_HZ, WOW_RATE_HZ };
+    memset(lfo, 0, sizeof(*lfo));
+    for (int k = 0; k < LFO_COUNT; k++) {
+        double cycles = (double)rates[k] * LFO_CONTROL_INTERVAL / sampleRate;
+        lfo->increment[k] = (uint32_t)(cycles * 4294967296.0);
+    }
+    /* Decorrelate the start phases */
+    lfo->phase[LFO_SCRAPE] = 0x55555555u;
+    lfo->phase[LFO_WOW] = 0xAAAAAAAAu;
+}
+
+static void FlutterLFO_SetDepth(FlutterLFO *lfo, float flutter, float wow) {
+    lfo->flutterDepth = flutter * MAX_FLUTTER_SECONDS;
+    lfo->wowDepth = wow * MAX_WOW_SECONDS;
+}
+
+static int FlutterLFO_IsActive(const FlutterLFO *lfo) {
+    return lfo->flutterDepth > 0.0f || lfo->wowDepth > 0.0f || lfo->value != 0.0f || lfo->slope != 0.0f;
+}
+
+/* Start the next segment: evaluate the table and aim at the new control point */
+static void FlutterLFO_ControlPoint(FlutterLFO *lfo) {
+    float flutter = lfo_sine(lfo->phase[LFO_FLUTTER]) + SCRAPE_LEVEL * lfo_sine(lfo->phase[LFO_SCRAPE]);
+    float target = lfo->flutterDepth * flutter * (1.0f / (1.0f + SCRAPE_LEVEL)) +
+                   lfo->wowDepth * lfo_sine(lfo->phase[LFO_WOW]);
+    for (int k = 0; k < LFO_COUNT; k++) {
+        lfo->phase[k] += lfo->increment[k];
+    }
+    lfo->countdown = LFO_CONTROL_INTERVAL;
+
+    /* Switched off and glided back to rest: settle exactly on zero */
+    if (lfo->flutterDepth == 0.0f && lfo->wowDepth == 0.0f && fabsf(lfo->value) < 1e-9f) {
+        lfo->value = 0.0f;
+        lfo->slope = 0.0f;
+        return;
+    }
+    lfo->slope = (target - lfo->value) * (1.0f / LFO_CONTROL_INTERVAL);
+}
+
+static float FlutterLFO_Next(FlutterLFO *lfo) {
+    if (lfo->countdown == 0) FlutterLFO_ControlPoint(lfo);
+    lfo->countdown--;
+    lfo->value += lfo->slope;
+    return lfo->value;
+}
+
+/* Fill dst with the next n offsets (same sequence as n Next calls) */
+static void FlutterLFO_Fill(FlutterLFO *lfo, float *dst, int n) {
+    int i = 0;
+    while (i < n) {
+        if (lfo->countdown == 0) FlutterLFO_ControlPoint(lfo);
+        int run = lfo->countdown < n - i ? lfo->countdown : n - i;
+        float value = lfo->value, slope = lfo->slope;
+        for (int k = 0; k < run; k++) {
+            value += slope;
+            dst[i + k] = value;
+        }
+        lfo->value = value;
+        lfo->countdown -= run;
+        i += run;
+    }
+}
+
+/* Advance n samples without producing values (bypass) */
+static void FlutterLFO_Advance(FlutterLFO *lfo, int n) {
+    while (n > 0) {
+        if (lfo->countdown == 0) FlutterLFO_ControlPoint(lfo);
+        int run = lfo->countdown < n ? lfo->countdown : n;
+        lfo->value += lfo->slope * (float)run;
+        lfo->countdown -= run;
+        n -= run;
+    }
+}
+
+/* ============================================================================
+ * INSTANCE ARENA - One aligned, pre-faulted allocation per instance
+ *
+ * The instance struct and kernel scratch are carved out of a single block
+ * (the delay buffer gets its own, see DELAY GROWTH) so teardown is one free
+ * and nothing is faulted in lazily on the audio thread. Optionally backed by
+ * transparent huge pages and mlock'd.
+ * ============================================================================ */
+
+#define ARENA_ALIGN 64                    /* cache line */
+#define ARENA_HUGE_PAGE_SIZE (2u << 20)   /* aarch64/x86_64 THP size */
+
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t used;
+    int locked;
+} Arena;
+
+static size_t Arena_AlignUp(size_t bytes) {
+    return (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static int Arena_Create(Arena *a, size_t size, int huge_pages) {
+    size_t align = ARENA_ALIGN;
+    void *p = NULL;
+
+    memset(a, 0, sizeof(*a));
+    if (huge_pages) {
+        align = ARENA_HUGE_PAGE_SIZE;
+        size = (size + align - 1) & ~(size_t)(align - 1);
+    } else {
+        size = Arena_AlignUp(size);
+    }
+    if (posix_memalign(&p, align, size) != 0) return -1;
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) madvise(p, size, MADV_HUGEPAGE);
+#endif
+
+    /* Zeroing touches every page, so all faults happen here */
+    memset(p, 0, size);
+    a->base = (uint8_t *)p;
+    a->size = size;
+    return 0;
+}
+
+static void *Arena_Alloc(Arena *a, size_t bytes) {
+    bytes = Arena_AlignUp(bytes);
+    if (a->used + bytes > a->size) return NULL;
+    void *p = a->base + a->used;
+    a->used += bytes;
+    return p;
+}
+
+static int Arena_Lock(Arena *a) {
+    if (mlock(a->base, a->size) != 0) return -1;
+    a->locked = 1;
+    return 0;
+}
+
+/* Safe to call with an arena that lives inside its own allocation */
+static void Arena_Release(Arena *a) {
+    uint8_t *base = a->base;
+    size_t size = a->size;
+    if (a->locked) munlock(base, size);
+    free(base);
+}
+
+/* ============================================================================
+ * SHARED STATE
+ * ============================================================================ */
+
+#define MAX_CHANNELS 2
+#define RAMP_SECONDS 0.05f     /* parameter ramp length (2205 samples at 44.1kHz) */
+#define CLOCKS_PER_QUARTER 24  /* MIDI standard: 24 PPQN */
+#define KERNEL_SCRATCH_BUFFERS 23
+#define KERNEL_SPAN_BUFFERS 2     /* grain source spans, 2 * chunkFrames each */
+
+/* Anything below this contributes under half an LSB to the int16 output,
+ * even after the 1.333x width compensation */
+#define TAIL_SILENCE_THRESHOLD (0.5f / 32768.0f / 1.333334f)
+
+static const host_api_v1_t *g_host = NULL;
+
+static void plugin_log(const char *msg) {
+    if (g_host && g_host->log) {
+        char buf[256];
+        snprintf(buf, sizeof(buf), "[tapedelay] %s", msg);
+        g_host->log(buf);
+    }
+}
+
+/* Convert milliseconds to seconds */
+static float GetDelayTimeSeconds(int ms) {
+    /* Clamp to valid range */
+    if (ms < 20) ms = 20;
+    if (ms > 2000) ms = 2000;
+    return (float)ms / 1000.0f;
+}
+
+static float GetFeedback(float normalized, float drive) {
+    /* 0-1 maps to 0-0.95; drive opens it up to 1.1 so the saturated loop can self-oscillate */
+    return normalized * (0.95f + 0.15f * drive);
+}
+
+static float GetDriveGain(float normalized) {
+    /* 0-1 maps to 1-4 (1 = saturation stage off) */
+    return 1.0f + 3.0f * normalized;
+}
+
+static float GetToneFrequency(float normalized) {
+    /* 0-1 maps to 500Hz-12000Hz (exponential) */
+    return 500.0f * powf(24.0f, normalized);
+}
+
+static float GetStereoWidth(int percent) {
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+    return (float)percent / 100.0f;
+}
+
+/* Wet level compensation for a stereo width, keeps perceived level stable */
+static float GetWidthLevelComp(float width) {
+    float comp = 1.0f / sqrtf(1.0f - 0.5f * width);
+    if (comp > 1.333333f) comp = 1.333333f;
+    return comp;
+}
+
+/* ============================================================================
+ * DELAY GROWTH - Delay buffer sized to use, grown without blocking audio
+ *
+ * The delay buffer starts just long enough for the configured max_delay_ms
+ * (default: the initial time) and grows by powers of two when a longer time
+ * is asked for, up to MAX_DELAY_SECONDS. A control thread allocates the
+ * larger buffer, copies the history into it up to the write count the audio
+ * thread last published, and offers it through a one-slot handshake. The
+ * audio thread swaps it in at the start of its next block, copying only the
+ * oldest DELAY_GROW_GUARD_FRAMES the control copy skipped and the frames
+ * written since (see StereoDelayLine_Grow).
+ *
+ * Control-side work (Reserve, Service) is serialized by a mutex the audio
+ * thread never takes. Each instance has a small service thread: the audio
+ * thread wakes it after a swap, to free the replaced buffer, and when a time
+ * that originated there (MIDI clock sync) needs more than the buffer holds,
+ * to grow it; that time reads clamped until the buffer arrives a few blocks
+ * later. Buffers never shrink.
+ * ============================================================================ */
+
+typedef enum {
+    DELAY_GROW_IDLE = 0,
+    DELAY_GROW_READY,     /* pending is on offer to the audio thread */
+    DELAY_GROW_SWAPPING,  /* audio thread is moving the history over */
+    DELAY_GROW_RETIRED    /* retired holds the replaced (or a refused) buffer */
+} DelayGrowState;
+
+typedef struct {
+    Arena current;          /* audio thread: buffer behind the delay line */
+    Arena pending;
+    Arena retired;
+    int currentLength;      /* audio thread: frames in current */
+    int pendingLength;
+    uint32_t copied;        /* write count pending holds the history up to */
+    int capacity;           /* control threads: length in use or on offer */
+    int maxLength;          /* StereoDelayLine_LengthFor(MAX_DELAY_SECONDS) */
+    size_t frameBytes;      /* delay_storage_frame_bytes of the line's storage */
+    int hugePages;
+    int lockMemory;
+    atomic_int state;
+    atomic_int wantLength;  /* audio thread: longest length a received time needed */
+    atomic_uint written;    /* audio thread: StereoDelayLine written at block start */
+    pthread_mutex_t lock;   /* control threads: everything above not marked audio */
+    sem_t wake;
+    atomic_int quit;
+    pthread_t thread;
+    int serviceRunning;
+} DelayGrowth;
+
+/* Zeroed buffer for 'length' frames; huge pages only once one is filled */
+static int DelayGrowth_Alloc(DelayGrowth *g, Arena *a, int length) {
+    size_t bytes = (size_t)length * g->frameBytes;
+    if (Arena_Create(a, bytes, g->hugePages && bytes >= ARENA_HUGE_PAGE_SIZE) != 0) return -1;
+    if (g->lockMemory && Arena_Lock(a) != 0) {
+        plugin_log("mlock failed, delay buffer left pageable");
+    }
+    return 0;
+}
+
+/* Either thread: raise wantLength to at least 'length'; nonzero if it rose */
+static int DelayGrowth_RaiseWant(DelayGrowth *g, int length) {
+    int want = atomic_load_explicit(&g->wantLength, memory_order_relaxed);
+    while (length > want) {
+        if (atomic_compare_exchange_weak_explicit(&g->wantLength, &want, length,
+                                                  memory_order_relaxed, memory_order_relaxed)) return 1;
+    }
+    return 0;
+}
+
+/* Control thread, lock held: free a replaced or refused buffer */
+static void DelayGrowth_Reclaim(DelayGrowth *g) {
+    int expected = DELAY_GROW_RETIRED;
+    if (atomic_compare_exchange_strong(&g->state, &expected, DELAY_GROW_IDLE)) {
+        Arena_Release(&g->retired);
+        g->capacity = g->currentLength;  /* a refused offer leaves current as it was */
+    }
+}
+
+/* Control thread, lock held: make sure a buffer of at least 'length' frames
+ * is in use or on offer. Fails quietly (the time clamps) if allocation fails. */
+static void DelayGrowth_ReserveLocked(DelayGrowth *g, int length) {
+    if (length > g->maxLength) length = g->maxLength;
+    DelayGrowth_Reclaim(g);
+    if (length <= g->capacity) return;
+
+    /* Withdraw an offer the audio thread has not taken yet */
+    int expected = DELAY_GROW_READY;
+    if (atomic_compare_exchange_strong(&g->state, &expected, DELAY_GROW_IDLE)) {
+        Arena_Release(&g->pending);
+    }
+    if (atomic_load_explicit(&g->state, memory_order_acquire) != DELAY_GROW_IDLE) {
+        DelayGrowth_RaiseWant(g, length);  /* mid-swap: the service thread retries after it */
+        return;
+    }
+
+    if (DelayGrowth_Alloc(g, &g->pending, length) != 0) {
+        plugin_log("Failed to grow delay buffer");
+        return;
+    }
+    /* current is stable while IDLE. The audio thread keeps writing past the
+     * published count, over the oldest slots, so the copy skips the guard
+     * frames; StereoDelayLine_Grow fills them and the frames written since. */
+    uint32_t copied = atomic_load_explicit(&g->written, memory_order_acquire);
+    uint32_t oldLength = (uint32_t)g->currentLength;
+    uint32_t guard = delay_grow_guard(oldLength);
+    delay_copy_frames(g->pending.base, (uint32_t)length - 1, g->current.base, oldLength - 1,
+                      copied - oldLength + guard, oldLength - guard, g->frameBytes);
+    g->copied = copied;
+    g->pendingLength = length;
+    g->capacity = length;
+    atomic_store_explicit(&g->state, DELAY_GROW_READY, memory_order_release);
+}
+
+/* set_param thread: grow ahead of a time change */
+static void DelayGrowth_Reserve(DelayGrowth *g, int length) {
+    pthread_mutex_lock(&g->lock);
+    DelayGrowth_ReserveLocked(g, length);
+    pthread_mutex_unlock(&g->lock);
+}
+
+/* Service thread: free a replaced buffer and follow up on audio-thread requests */
+static void DelayGrowth_Service(DelayGrowth *g) {
+    pthread_mutex_lock(&g->lock);
+    DelayGrowth_Reclaim(g);
+    int want = atomic_load_explicit(&g->wantLength, memory_order_relaxed);
+    if (want > g->capacity) DelayGrowth_ReserveLocked(g, want);
+    pthread_mutex_unlock(&g->lock);
+}
+
+static void *DelayGrowth_Main(void *arg) {
+    DelayGrowth *g = (DelayGrowth *)arg;
+    for (;;) {
+        sem_wait(&g->wake);
+        if (atomic_load_explicit(&g->quit, memory_order_acquire)) break;
+        DelayGrowth_Service(g);
+    }
+    return NULL;
+}
+
+static int DelayGrowth_Init(DelayGrowth *g, int length, int maxLength, size_t frameBytes,
+                            int huge_pages, int lock_memory) {
+    memset(g, 0, sizeof(*g));
+    g->maxLength = maxLength;
+    g->frameBytes = frameBytes;
+    g->hugePages = huge_pages;
+    g->lockMemory = lock_memory;
+    g->capacity = length < maxLength ? length : maxLength;
+    g->currentLength = g->capacity;
+    atomic_init(&g->state, DELAY_GROW_IDLE);
+    atomic_init(&g->wantLength, 0);
+    atomic_init(&g->written, 0);
+    atomic_init(&g->quit, 0);
+    if (DelayGrowth_Alloc(g, &g->current, g->capacity) != 0) return -1;
+    pthread_mutex_init(&g->lock, NULL);
+    if (sem_init(&g->wake, 0, 0) == 0) {
+        if (pthread_create(&g->thread, NULL, DelayGrowth_Main, g) == 0) g->serviceRunning = 1;
+        else sem_destroy(&g->wake);
+    }
+    if (!g->serviceRunning) {
+        plugin_log("Delay growth thread failed to start, clock-synced times clamp to the buffer");
+    }
+    return 0;
+}
+
+/* Audio thread: note a time the current buffer cannot reach */
+static inline void DelayGrowth_Want(DelayGrowth *g, const StereoDelayLine *dl, int length) {
+    if (length > dl->bufferLength && DelayGrowth_RaiseWant(g, length) && g->serviceRunning) {
+        sem_post(&g->wake);
+    }
+}
+
+/* Audio thread, start of a block: publish the write count and swap in an
+ * offered buffer. Returns the old length when it did, 0 otherwise. */
+static int DelayGrowth_Take(DelayGrowth *g, StereoDelayLine *dl) {
+    atomic_store_explicit(&g->written, dl->written, memory_order_release);
+    if (atomic_load_explicit(&g->state, memory_order_relaxed) != DELAY_GROW_READY) return 0;
+    int expected = DELAY_GROW_READY;
+    if (!atomic_compare_exchange_strong_explicit(&g->state, &expected, DELAY_GROW_SWAPPING,
+                                                 memory_order_acquire, memory_order_relaxed)) return 0;
+    int oldLength = dl->bufferLength;
+    if (StereoDelayLine_Grow(dl, g->pending.base, g->pendingLength, g->copied)) {
+        g->retired = g->current;
+        g->current = g->pending;
+        g->currentLength = g->pendingLength;
+    } else {
+        /* The copy is over a buffer old (the offering thread stalled): refuse it */
+        g->retired = g->pending;
+        DelayGrowth_RaiseWant(g, g->pendingLength);
+        oldLength = 0;
+    }
+    atomic_store_explicit(&g->state, DELAY_GROW_RETIRED, memory_order_release);
+    if (g->serviceRunning) sem_post(&g->wake);
+    return oldLength;
+}
+
+/* Teardown, with the audio side stopped */
+static void DelayGrowth_Release(DelayGrowth *g) {
+    if (g->serviceRunning) {
+        atomic_store_explicit(&g->quit, 1, memory_order_release);
+        sem_post(&g->wake);
+        pthread_join(g->thread, NULL);
+        sem_destroy(&g->wake);
+    }
+    pthread_mutex_destroy(&g->lock);
+    int state = atomic_load(&g->state);
+    if (state == DELAY_GROW_READY) Arena_Release(&g->pending);
+    if (state == DELAY_GROW_RETIRED) Arena_Release(&g->retired);
+    Arena_Release(&g->current);
+}
+
+/* ============================================================================
+ * TONE TABLE - One-pole coefficients over the normalized tone range
+ *
+ * b1 = exp(-2*pi*fc/fs) for fc = GetToneFrequency(tone), sampled at
+ * TONE_TABLE_SIZE + 1 points when the instance is created. Lookups
+ * interpolate linearly, so tone ramps cost no powf/expf per sample.
+ * ============================================================================ */
+
+#define TONE_TABLE_SIZE 128
+
+typedef struct {
+    float b1[TONE_TABLE_SIZE + 2];  /* one guard entry so tone == 1.0 needs no branch */
+} ToneTable;
+
+static void ToneTable_Init(ToneTable *t, float sampleRate) {
+    OnePoleFilter f;
+    for (int i = 0; i <= TONE_TABLE_SIZE; i++) {
+        OnePoleFilter_SetCutoff(&f, GetToneFrequency((float)i / (float)TONE_TABLE_SIZE), sampleRate);
+        t->b1[i] = f.b1;
+    }
+    t->b1[TONE_TABLE_SIZE + 1] = t->b1[TONE_TABLE_SIZE];
+}
+
+static inline float ToneTable_Lookup(const ToneTable *t, float tone) {
+    float position = fminf(fmaxf(tone, 0.0f), 1.0f) * (float)TONE_TABLE_SIZE;
+    int index = (int)position;
+    float fraction = position - (float)index;
+    return t->b1[index] + fraction * (t->b1[index + 1] - t->b1[index]);
+}
+
+/* ============================================================================
+ * TEMPO SYNC - Musical division to delay time
+ * ============================================================================ */
+
+enum {
+    DIV_FREE = 0,
+    DIV_1_1,
+    DIV_1_2,
+    DIV_1_2D,
+    DIV_1_4,
+    DIV_1_4D,
+    DIV_1_4T,
+    DIV_1_8,
+    DIV_1_8D,
+    DIV_1_8T,
+    DIV_1_16,
+    DIV_1_16T,
+    DIV_COUNT
+};
+
+#define DIVISION_OPTIONS(FIRST, NEXT) \
+    FIRST("free") NEXT("1/1") NEXT("1/2") NEXT("1/2d") NEXT("1/4") NEXT("1/4d") NEXT("1/4t") \
+    NEXT("1/8") NEXT("1/8d") NEXT("1/8t") NEXT("1/16") NEXT("1/16t")
+
+static const char *division_names[] = { DIVISION_OPTIONS(OPTION_NAME, OPTION_NAME) };
+
+_Static_assert(OPTION_COUNT(division_names) == DIV_COUNT, "one label per division");
+
+#define DIVISION_OPTIONS_JSON OPTIONS_JSON(DIVISION_OPTIONS)
+
+static const float division_multipliers[] = {
+    0.0f,      /* free - unused */
+    4.0f,      /* 1/1  = whole note */
+    2.0f,      /* 1/2  = half note */
+    3.0f,      /* 1/2d = dotted half */
+    1.0f,      /* 1/4  = quarter note */
+    1.5f,      /* 1/4d = dotted quarter */
+    0.66667f,  /* 1/4t = quarter triplet */
+    0.5f,      /* 1/8  = eighth note */
+    0.75f,     /* 1/8d = dotted eighth */
+    0.33333f,  /* 1/8t = eighth triplet */
+    0.25f,     /* 1/16 = sixteenth */
+    0.16667f   /* 1/16t = sixteenth triplet */
+};
+
+/* Compute delay time in (fractional) ms from BPM and division, clamped to 20-2000ms */
+static float compute_synced_time(float bpm, int division) {
+    if (division <= DIV_FREE || division >= DIV_COUNT) return -1.0f;
+    float beat_ms = 60000.0f / bpm;
+    float ms = division_multipliers[division] * beat_ms;
+    if (ms < 20.0f) ms = 20.0f;
+    if (ms > 2000.0f) ms = 2000.0f;
+    return ms;
+}
+
+/* The MIDI clock publishes its tempo as one word, publication count << 32 |
+ * float bits, so the kernel and the control side each see a new tempo once */
+static uint64_t clock_tempo_pack(uint32_t seq, float bpm) {
+    uint32_t bits;
+    memcpy(&bits, &bpm, sizeof(bits));
+    return ((uint64_t)seq << 32) | bits;
+}
+
+static float clock_tempo_bpm(uint64_t tempo) {
+    uint32_t bits = (uint32_t)tempo;
+    float bpm;
+    memcpy(&bpm, &bits, sizeof(bpm));
+    return bpm;
+}
+
+/* ============================================================================
+ * TEMPO TRACKER - Least-squares tempo fit over timestamped MIDI clock ticks
+ *
+ * Each 0xF8 is stamped with its absolute sample position. The tick period is
+ * the least-squares slope of position against tick number over the last
+ * TEMPO_WINDOW ticks, so block-quantized arrival jitter averages out and a
+ * tempo ramp is followed tick by tick instead of once per quarter note.
+ * ============================================================================ */
+
+#define TEMPO_WINDOW 48            /* ticks in the fit (two quarter notes) */
+#define TEMPO_MIN_TICKS CLOCKS_PER_QUARTER
+#define TEMPO_MAX_GAP_SECONDS 0.125f  /* longer tick gaps (40 BPM = 62.5ms) restart the fit */
+
+typedef struct {
+    int64_t ticks[TEMPO_WINDOW];   /* ring of tick sample positions */
+    int head;                      /* next write slot */
+    int count;                     /* valid ticks in the ring */
+} TempoTracker;
+
+static void TempoTracker_Reset(TempoTracker *tt) {
+    tt->head = 0;
+    tt->count = 0;
+}
+
+/* Add a tick; returns 1 and writes the fitted BPM once enough ticks are in */
+static int TempoTracker_Tick(TempoTracker *tt, int64_t position, float sampleRate, float *bpm) {
+    if (tt->count > 0) {
+        int64_t last = tt->ticks[(tt->head + TEMPO_WINDOW - 1) % TEMPO_WINDOW];
+        int64_t gap = position - last;
+        if (gap <= 0 || gap > (int64_t)(TEMPO_MAX_GAP_SECONDS * sampleRate)) TempoTracker_Reset(tt);
+    }
+    tt->ticks[tt->head] = position;
+    tt->head = (tt->head + 1) % TEMPO_WINDOW;
+    if (tt->count < TEMPO_WINDOW) tt->count++;
+    if (tt->count < TEMPO_MIN_TICKS) return 0;
+
+    /* slope = sum((i - ibar)(t - tbar)) / sum((i - ibar)^2), times relative to the oldest tick */
+    const int n = tt->count;
+    const int first = (tt->head + TEMPO_WINDOW - n) % TEMPO_WINDOW;
+    const int64_t origin = tt->ticks[first];
+    const double ibar = 0.5 * (double)(n - 1);
+    double tsum = 0.0;
+    for (int i = 0; i < n; i++) tsum += (double)(tt->ticks[(first + i) % TEMPO_WINDOW] - origin);
+    const double tbar = tsum / (double)n;
+    double num = 0.0;
+    for (int i = 0; i < n; i++) {
+        num += ((double)i - ibar) * ((double)(tt->ticks[(first + i) % TEMPO_WINDOW] - origin) - tbar);
+    }
+    const double den = (double)n * ((double)n * (double)n - 1.0) / 12.0;
+    const double period = num / den;
+    if (period <= 0.0) return 0;
+
+    *bpm = (float)(60.0 * (double)sampleRate / (period * CLOCKS_PER_QUARTER));
+    return 1;
+}
+
+/* ============================================================================
+ * TIME MODE - How main-head delay-time changes are applied
+ *
+ * glide ramps the delay over RAMP_SECONDS (tape-style pitch bend). jump
+ * snaps the delay to whole samples and equal-power crossfades from the old
+ * head to one starting at the new time over JUMP_FADE_SECONDS; a jump that
+ * arrives mid-fade waits for it to finish. Taps always glide.
+ * ============================================================================ */
+
+typedef enum {
+    TIME_MODE_GLIDE = 0,
+    TIME_MODE_JUMP,
+    TIME_MODE_COUNT
+} TimeMode;
+
+#define TIME_MODE_OPTIONS(FIRST, NEXT) FIRST("glide") NEXT("jump")
+
+static const char *time_mode_names[] = { TIME_MODE_OPTIONS(OPTION_NAME, OPTION_NAME) };
+
+_Static_assert(OPTION_COUNT(time_mode_names) == TIME_MODE_COUNT, "one label per TimeMode");
+
+#define TIME_MODE_OPTIONS_JSON OPTIONS_JSON(TIME_MODE_OPTIONS)
+#define JUMP_FADE_SECONDS 0.02f   /* crossfade length (882 samples at 44.1kHz) */
+
+/* ============================================================================
+ * FREEZE - Hold the delay content as a loop
+ *
+ * Freezing stops every write to the delay line (input, feedback and
+ * saturation are skipped) and plays the last loop-length frames before the
+ * write head round and round as whole-sample copies. The loop length is the
+ * main delay time, so a synced division makes it a tempo-locked looper; a
+ * time change while frozen takes effect at the next loop wrap. Taps are
+ * silent while frozen. Releasing crossfades (JUMP_FADE_SECONDS) from the loop
+ * position back to the main head, and the loop decays with the feedback.
+ * ============================================================================ */
+
+typedef enum {
+    FREEZE_OFF = 0,
+    FREEZE_ON,
+    FREEZE_COUNT
+} FreezeMode;
+
+#define FREEZE_OPTIONS(FIRST, NEXT) FIRST("off") NEXT("on")
+
+static const char *freeze_names[] = { FREEZE_OPTIONS(OPTION_NAME, OPTION_NAME) };
+
+_Static_assert(OPTION_COUNT(freeze_names) == FREEZE_COUNT, "one label per FreezeMode");
+
+#define FREEZE_OPTIONS_JSON OPTIONS_JSON(FREEZE_OPTIONS)
+
+/* ============================================================================
+ * PLAYBACK - Reverse and half/double-speed main head in grains
+ *
+ * Outside forward, the main head plays grains one main delay time long (so a
+ * synced division sizes them): reverse plays the last grain length backwards,
+ * half plays half a grain length at half speed, double two at double speed.
+ * Each grain starts from the write position it begins at and reads only
+ * whole or half frames: a grain span is copied out of the delay line in bulk
+ * (StereoDelayLine_CopyFrames) and reversed, decimated or interpolated in
+ * registers, with no per-frame fractional position. Flutter, wow and the
+ * quality setting apply to forward playback only.
+ *
+ * Consecutive grains, and a mode change, overlap by an equal-power
+ * crossfade of up to GRAIN_FADE_SECONDS (at most a quarter grain). At the
+ * end of its fade a reverse grain reaches PLAYBACK_REACH grain lengths back,
+ * so grains are shortened to what the delay buffer holds.
+ * ============================================================================ */
+
+typedef enum {
+    PLAYBACK_FORWARD = 0,
+    PLAYBACK_REVERSE,
+    PLAYBACK_HALF,
+    PLAYBACK_DOUBLE,
+    PLAYBACK_COUNT
+} PlaybackMode;
+
+#define PLAYBACK_OPTIONS(FIRST, NEXT) FIRST("forward") NEXT("reverse") NEXT("half") NEXT("double")
+
+static const char *playback_names[] = { PLAYBACK_OPTIONS(OPTION_NAME, OPTION_NAME) };
+
+_Static_assert(OPTION_COUNT(playback_names) == PLAYBACK_COUNT, "one label per PlaybackMode");
+
+#define PLAYBACK_OPTIONS_JSON OPTIONS_JSON(PLAYBACK_OPTIONS)
+#define GRAIN_FADE_SECONDS 0.01f  /* grain crossfade length (441 samples at 44.1kHz) */
+#define PLAYBACK_REACH 2.5f       /* longest grain read, in grain lengths */
+
+typedef struct {
+    int mode;          /* PlaybackMode; PLAYBACK_FORWARD is the regular main head */
+    uint32_t start;    /* delay-line frame played at elapsed 0 */
+    int elapsed;       /* frames played since the grain started */
+} PlaybackGrain;
+
+/* A grain of 'length' frames from writePos on. Half and double speed end one
+ * length behind the write head; reverse starts 'lead' frames behind it (the
+ * block kernel reads a chunk before writing it). */
+static void PlaybackGrain_Start(PlaybackGrain *g, int mode, uint32_t writePos, int length, int lead) {
+    g->mode = mode;
+    g->elapsed = 0;
+    switch (mode) {
+    case PLAYBACK_REVERSE: g->start = writePos - (uint32_t)lead; break;
+    case PLAYBACK_HALF: g->start = writePos - (uint32_t)length; break;
+    case PLAYBACK_DOUBLE: g->start = writePos - 2u * (uint32_t)length; break;
+    default: g->start = writePos; break;
+    }
+}
+
+/* dst[i] = src[n - 1 - i] */
+static void grain_reverse(const float *src, float *dst, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vrev64q_f32(vld1q_f32(src + n - 4 - i));
+        vst1q_f32(dst + i, vcombine_f32(vget_high_f32(v), vget_low_f32(v)));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = src[n - 1 - i];
+    }
+}
+
+/* Half speed from an even phase: dst[2k] = src[k], dst[2k+1] = midpoint */
+static void grain_stretch(const float *src, float *dst, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vld1q_f32(src + i / 2);
+        float32x4_t mid = vmulq_n_f32(vaddq_f32(a, vld1q_f32(src + i / 2 + 1)), 0.5f);
+        float32x4x2_t z = vzipq_f32(a, mid);
+        vst1q_f32(dst + i, z.val[0]);
+        vst1q_f32(dst + i + 4, z.val[1]);
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = (i & 1) ? 0.5f * (src[i / 2] + src[i / 2 + 1]) : src[i / 2];
+    }
+}
+
+/* Double speed: each output frame averages two source frames */
+static void grain_squeeze(const float *src, float *dst, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 4 <= n; i += 4) {
+        float32x4x2_t v = vld2q_f32(src + i * 2);
+        vst1q_f32(dst + i, vmulq_n_f32(vaddq_f32(v.val[0], v.val[1]), 0.5f));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = 0.5f * (src[i * 2] + src[i * 2 + 1]);
+    }
+}
+
+/* Play n frames of a (non-forward) grain into l/r; spanL/R hold 2n frames */
+static void PlaybackGrain_Read(const StereoDelayLine *dl, const PlaybackGrain *g, float *spanL, float *spanR,
+                               float *l, float *r, int n) {
+    const uint32_t e = (uint32_t)g->elapsed;
+    switch (g->mode) {
+    case PLAYBACK_REVERSE:
+        StereoDelayLine_CopyFrames(dl, g->start - e - (uint32_t)(n - 1), spanL, spanR, n);
+        grain_reverse(spanL, l, n);
+        grain_reverse(spanR, r, n);
+        break;
+    case PLAYBACK_HALF: {
+        /* An odd phase starts half a frame in: emit the midpoint first */
+        const int odd = (int)(e & 1u);
+        const int frames = (n + odd) / 2 + 1;
+        StereoDelayLine_CopyFrames(dl, g->start + e / 2, spanL, spanR, frames);
+        if (odd) {
+            l[0] = 0.5f * (spanL[0] + spanL[1]);
+            r[0] = 0.5f * (spanR[0] + spanR[1]);
+        }
+        grain_stretch(spanL + odd, l + odd, n - odd);
+        grain_stretch(spanR + odd, r + odd, n - odd);
+        break;
+    }
+    case PLAYBACK_DOUBLE:
+        StereoDelayLine_CopyFrames(dl, g->start + 2u * e, spanL, spanR, 2 * n);
+        grain_squeeze(spanL, l, n);
+        grain_squeeze(spanR, r, n);
+        break;
+    }
+}
+
+/* ============================================================================
+ * DUCKING - Wet level follows the dry input's envelope
+ *
+ * The detector runs once per DUCK_DETECT_FRAMES: the stereo peak of that
+ * segment of dry input drives a peak follower (DUCK_ATTACK_SECONDS up,
+ * DUCK_RELEASE_SECONDS down), whose level maps to a wet gain of
+ * 1 - ducking * min(envelope / DUCK_RANGE, 1). Over the following segment
+ * the gain moves linearly to it, so each frame costs one multiply-add and the
+ * gain lags the input by one segment. Only the output is ducked; the delay
+ * line is fed as before. Ducking 0 switches the detector off.
+ * ============================================================================ */
+
+#define DUCK_DETECT_FRAMES 16        /* detector decimation (0.36ms at 44.1kHz) */
+#define DUCK_ATTACK_SECONDS 0.005f
+#define DUCK_RELEASE_SECONDS 0.25f
+#define DUCK_RANGE 0.25f             /* envelope for full depth (-12dBFS peak) */
+
+typedef struct {
+    float depth;       /* audio thread's copy of the ducking param, 0 = off */
+    float envelope;
+    float peak;        /* running peak of the segment in progress */
+    int count;         /* frames into it */
+    float gainFrom;    /* gain ramp over the segment in progress */
+    float gainTo;
+    float attack;      /* follower coefficients per segment */
+    float release;
+} DuckFollower;
+
+static void DuckFollower_Reset(DuckFollower *d) {
+    d->envelope = 0.0f;
+    d->peak = 0.0f;
+    d->count = 0;
+    d->gainFrom = d->gainTo = 1.0f;
+}
+
+static void DuckFollower_Init(DuckFollower *d, float sampleRate) {
+    d->depth = 0.0f;
+    d->attack = expf(-(float)DUCK_DETECT_FRAMES / (DUCK_ATTACK_SECONDS * sampleRate));
+    d->release = expf(-(float)DUCK_DETECT_FRAMES / (DUCK_RELEASE_SECONDS * sampleRate));
+    DuckFollower_Reset(d);
+}
+
+/* Peak of |l|, |r| over n frames */
+static float duck_peak(const float *l, const float *r, int n) {
+    float peak = 0.0f;
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        acc = vmaxq_f32(acc, vmaxq_f32(vabsq_f32(vld1q_f32(l + i)), vabsq_f32(vld1q_f32(r + i))));
+    }
+    peak = vmaxvq_f32(acc);
+#endif
+    for (; i < n; i++) {
+        peak = fmaxf(peak, fmaxf(fabsf(l[i]), fabsf(r[i])));
+    }
+    return peak;
+}
+
+/* Detect over n frames of dry input (NULL: silence) and write their wet
+ * gains (NULL: detect only) */
+static void DuckFollower_Fill(DuckFollower *d, const float *l, const float *r, float *gains, int n) {
+    const float inv = 1.0f / (float)DUCK_DETECT_FRAMES;
+    int done = 0;
+    while (done < n) {
+        int span = DUCK_DETECT_FRAMES - d->count;
+        if (span > n - done) span = n - done;
+        if (l) d->peak = fmaxf(d->peak, duck_peak(l + done, r + done, span));
+        if (gains) {
+            const float step = (d->gainTo - d->gainFrom) * inv;
+            for (int i = 0; i < span; i++) {
+                gains[done + i] = d->gainFrom + step * (float)(d->count + i + 1);
+            }
+        }
+        d->count += span;
+        done += span;
+        if (d->count == DUCK_DETECT_FRAMES) {
+            const float coeff = d->peak > d->envelope ? d->attack : d->release;
+            d->envelope = d->peak + (d->envelope - d->peak) * coeff;
+            d->gainFrom = d->gainTo;
+            d->gainTo = 1.0f - d->depth * fminf(d->envelope * (1.0f / DUCK_RANGE), 1.0f);
+            d->peak = 0.0f;
+            d->count = 0;
+        }
+    }
+}
+
+/* ============================================================================
+ * MULTI-TAP - Extra playback heads on the shared delay line
+ * ============================================================================ */
+
+#define MAX_TAPS 8
+
+typedef struct {
+    int param_time;            /* milliseconds (20-2000) */
+    int param_division;        /* DIV_FREE or tempo-synced division */
+    float param_gain;          /* 0-1 */
+    float param_pan;           /* -1 (left) .. 1 (right) */
+
+    SmoothedValue smoothedTime;   /* seconds */
+    SmoothedValue smoothedGainL;  /* gain with equal-power pan applied */
+    SmoothedValue smoothedGainR;
+
+    float allpassState[2];        /* previous L/R output of the allpass interpolator */
+    int syncDivision;             /* audio thread's copy of param_division */
+} DelayTap;
+
+static void DelayTap_PanGains(const DelayTap *tap, float *gainL, float *gainR) {
+    float angle = (tap->param_pan + 1.0f) * 0.25f * 3.14159265f;
+    *gainL = tap->param_gain * cosf(angle);
+    *gainR = tap->param_gain * sinf(angle);
+}
+
+static void DelayTap_Init(DelayTap *tap, int index) {
+    /* Defaults: evenly spaced eighths at 120 BPM, alternating pan */
+    tap->param_time = 250 * (index + 1);
+    tap->param_division = DIV_FREE;
+    tap->syncDivision = DIV_FREE;
+    tap->param_gain = 0.5f;
+    tap->param_pan = (index & 1) ? 0.5f : -0.5f;
+
+    float gainL, gainR;
+    DelayTap_PanGains(tap, &gainL, &gainR);
+    SmoothedValue_Init(&tap->smoothedTime, GetDelayTimeSeconds(tap->param_time));
+    SmoothedValue_Init(&tap->smoothedGainL, gainL);
+    SmoothedValue_Init(&tap->smoothedGainR, gainR);
+}
+
+/* ============================================================================
+ * PARAM QUEUE - Lock-free SPSC ring from set_param to the audio thread
+ *
+ * set_param (UI/shadow thread) parses values, keeps the param_* copies that
+ * get_param reports, and posts ready-to-apply targets here. process_block
+ * drains the ring at the start of each block, so the smoothing and filter
+ * state is only ever touched by the audio thread. Every push also records
+ * the event as the latest of its type and tap, in atomics beside the ring.
+ * If the ring is full the event is dropped and a resync flag makes the audio
+ * thread replay those latest events instead, so it never reads the param_*
+ * copies set_param is writing.
+ * ============================================================================ */
+
+#define PARAM_QUEUE_SIZE 256  /* power of two */
+
+typedef enum {
+    PARAM_EVENT_DELAY_TIME = 0,  /* a = seconds */
+    PARAM_EVENT_FEEDBACK,        /* a = feedback gain */
+    PARAM_EVENT_DRIVE,           /* a = saturation drive gain */
+    PARAM_EVENT_OVERSAMPLING,    /* a = Oversampling */
+    PARAM_EVENT_MIX,             /* a = mix */
+    PARAM_EVENT_TONE,            /* a = normalized tone */
+    PARAM_EVENT_WIDTH,           /* a = width 0-1 */
+    PARAM_EVENT_MODULATION,      /* a = flutter, b = wow */
+    PARAM_EVENT_QUALITY,         /* a = InterpMode */
+    PARAM_EVENT_TIME_MODE,       /* a = TimeMode */
+    PARAM_EVENT_TAPS,            /* a = active tap count */
+    PARAM_EVENT_FREEZE,          /* a = FreezeMode */
+    PARAM_EVENT_PLAYBACK,        /* a = PlaybackMode */
+    PARAM_EVENT_DUCKING,         /* a = ducking depth */
+    PARAM_EVENT_TAP_TIME,        /* tap, a = seconds */
+    PARAM_EVENT_TAP_GAINS,       /* tap, a = left gain, b = right gain */
+    PARAM_EVENT_DIVISION,        /* a = division of the main head */
+    PARAM_EVENT_TAP_DIVISION,    /* tap, a = division */
+    PARAM_EVENT_BPM,             /* a = tempo of the synced heads */
+    PARAM_EVENT_COUNT
+} ParamEventType;
+
+typedef struct {
+    uint8_t type;
+    uint8_t tap;
+    float a;
+    float b;
+} ParamEvent;
+
+typedef struct {
+    ParamEvent events[PARAM_QUEUE_SIZE];
+    _Atomic uint32_t head;   /* next slot to write, owned by the producer */
+    _Atomic uint32_t tail;   /* next slot to read, owned by the consumer */
+    _Atomic int resync;      /* set by the producer when an event was dropped */
+    /* Latest event per type and tap (global types use tap 0): b bits << 32 | a bits */
+    _Atomic uint64_t latest[PARAM_EVENT_COUNT][MAX_TAPS];
+} ParamQueue;
+
+static void ParamQueue_Init(ParamQueue *q) {
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->resync, 0);
+    for (int type = 0; type < PARAM_EVENT_COUNT; type++) {
+        for (int tap = 0; tap < MAX_TAPS; tap++) atomic_init(&q->latest[type][tap], 0);
+    }
+}
+
+/* Producer side: keep ev as the latest of its type and tap. Relaxed, the
+ * release on head or resync that follows publishes it. */
+static void ParamQueue_Record(ParamQueue *q, const ParamEvent *ev) {
+    uint32_t a, b;
+    memcpy(&a, &ev->a, sizeof(a));
+    memcpy(&b, &ev->b, sizeof(b));
+    atomic_store_explicit(&q->latest[ev->type][ev->tap], ((uint64_t)b << 32) | a, memory_order_relaxed);
+}
+
+/* Consumer side, after ParamQueue_TakeResync: the latest event of a type and tap */
+static void ParamQueue_Latest(ParamQueue *q, int type, int tap, ParamEvent *ev) {
+    uint64_t v = atomic_load_explicit(&q->latest[type][tap], memory_order_relaxed);
+    uint32_t a = (uint32_t)v, b = (uint32_t)(v >> 32);
+    ev->type = (uint8_t)type;
+    ev->tap = (uint8_t)tap;
+    memcpy(&ev->a, &a, sizeof(a));
+    memcpy(&ev->b, &b, sizeof(b));
+}
+
+/* Producer side. Returns 0, or -1 (and flags a resync) when full. */
+static int ParamQueue_Push(ParamQueue *q, const ParamEvent *ev) {
+    ParamQueue_Record(q, ev);
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head - tail >= PARAM_QUEUE_SIZE) {
+        atomic_store_explicit(&q->resync, 1, memory_order_release);
+        return -1;
+    }
+    q->events[head & (PARAM_QUEUE_SIZE - 1)] = *ev;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return 0;
+}
+
+/* Consumer side. Returns 1 and fills ev, or 0 when empty. */
+static int ParamQueue_Pop(ParamQueue *q, ParamEvent *ev) {
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (tail == head) return 0;
+    *ev = q->events[tail & (PARAM_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+/* Consumer side: true once per dropped-event episode */
+static int ParamQueue_TakeResync(ParamQueue *q) {
+    if (!atomic_load_explicit(&q->resync, memory_order_relaxed)) return 0;
+    return atomic_exchange_explicit(&q->resync, 0, memory_order_acquire);
+}
+
+/* ============================================================================
+ * FLUSH TO ZERO - Denormal protection for the audio callback
+ *
+ * Once input stops, the feedback recirculation and the one-pole and allpass
+ * recursions decay into subnormal range, where each operation can cost a
+ * microcode assist (and a one-pole with its pole above 0.5 never leaves it).
+ * -Ofast only sets FZ in an executable's startup code and the host owns the
+ * audio thread's FPCR, so every callback sets FZ itself and restores the
+ * caller's mode on the way out; the register is only written when the bit
+ * is not already set.
+ *
+ * Targets without an FZ control add DENORMAL_DC to every delay-line write
+ * instead: far below one LSB, but it keeps the loop and everything it feeds
+ * in normal range.
+ * ============================================================================ */
+
+#if defined(__SSE__)
+#define SPACECHO_HAVE_FTZ 1
+#define FTZ_BITS 0x8040u  /* MXCSR FTZ | DAZ */
+
+static inline uint64_t ftz_read(void) {
+    return _mm_getcsr();
+}
+
+static inline void ftz_write(uint64_t mode) {
+    _mm_setcsr((unsigned)mode);
+}
+#elif defined(__aarch64__)
+#define SPACECHO_HAVE_FTZ 1
+#define FTZ_BITS (1u << 24)  /* FPCR.FZ */
+
+static inline uint64_t ftz_read(void) {
+    uint64_t mode;
+    __asm__ volatile("mrs %0, fpcr" : "=r"(mode) : : "memory");
+    return mode;
+}
+
+static inline void ftz_write(uint64_t mode) {
+    __asm__ volatile("msr fpcr, %0" : : "r"(mode) : "memory");
+}
+#else
+#define DENORMAL_DC 1e-18f
+#endif
+
+/* Enable flush-to-zero; returns the caller's mode for ftz_leave */
+static inline uint64_t ftz_enter(void) {
+#ifdef SPACECHO_HAVE_FTZ
+    uint64_t saved = ftz_read();
+    if ((saved & FTZ_BITS) != FTZ_BITS) ftz_write(saved | FTZ_BITS);
+    return saved;
+#else
+    return 0;
+#endif
+}
+
+static inline void ftz_leave(uint64_t saved) {
+#ifdef SPACECHO_HAVE_FTZ
+    if ((saved & FTZ_BITS) != FTZ_BITS) ftz_write(saved);
+#else
+    (void)saved;
+#endif
+}
+
+/* ============================================================================
+ * WORKER - Optional pinned thread running an instance one block behind
+ *
+ * The audio thread hands each block to the worker through two slots and
+ * returns the block the worker finished since the previous callback, so
+ * output lags input by exactly one block. Slot ownership moves through an
+ * atomic state (FREE -> QUEUED -> DONE -> FREE) and the worker is woken with
+ * sem_post, so the audio thread never waits on it.
+ * ============================================================================ */
+
+enum { WORKER_SLOT_FREE = 0, WORKER_SLOT_QUEUED, WORKER_SLOT_DONE };
+
+typedef struct {
+    int16_t *audio;        /* interleaved stereo, capacity frames */
+    int frames;
+    atomic_int state;
+} WorkerSlot;
+
+typedef void (*WorkerRun)(void *arg, int16_t *audio, int frames);
+
+typedef struct {
+    WorkerSlot slots[2];
+    int16_t *hold;         /* finished block, parked while its slot is refilled */
+    int capacity;          /* frames per slot (host block size) */
+    int head;              /* audio thread: next slot to submit */
+    int tail;              /* audio thread: next slot to collect */
+    uint32_t xruns;        /* blocks dropped or output as silence */
+    WorkerRun run;
+    void *arg;
+    sem_t wake;
+    atomic_int quit;
+    pthread_t thread;
+    int running;
+} Worker;
+
+/* Two slots plus the hold buffer */
+static size_t Worker_BufferBytes(int capacity) {
+    return (size_t)capacity * 2 * sizeof(int16_t) * 3;
+}
+
+static void *Worker_Main(void *arg) {
+    Worker *w = (Worker *)arg;
+    int next = 0;  /* slots are filled and drained in ring order */
+    ftz_enter();   /* the thread is ours, leave FZ on for its lifetime */
+    for (;;) {
+        sem_wait(&w->wake);
+        if (atomic_load_explicit(&w->quit, memory_order_acquire)) break;
+        WorkerSlot *slot = &w->slots[next];
+        while (atomic_load_explicit(&slot->state, memory_order_acquire) == WORKER_SLOT_QUEUED) {
+            w->run(w->arg, slot->audio, slot->frames);
+            atomic_store_explicit(&slot->state, WORKER_SLOT_DONE, memory_order_release);
+            next ^= 1;
+            slot = &w->slots[next];
+        }
+    }
+    return NULL;
+}
+
+/* Spread workers over the cores after the first, which is left to the host */
+static void Worker_Pin(pthread_t thread) {
+#ifdef CPU_SET
+    static atomic_int next_core = 0;  /* round-robin over instances */
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 2) return;
+    int core = 1 + atomic_fetch_add(&next_core, 1) % (int)(cores - 1);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (pthread_setaffinity_np(thread, sizeof(set), &set) != 0) {
+        plugin_log("Worker affinity not set, thread left unpinned");
+    }
+#else
+    (void)thread;
+#endif
+}
+
+/* buffers: Worker_BufferBytes(capacity). Returns 0 once the thread runs. */
+static int Worker_Start(Worker *w, int16_t *buffers, int capacity, WorkerRun run, void *arg) {
+    for (int s = 0; s < 2; s++) {
+        w->slots[s].audio = buffers + (size_t)s * capacity * 2;
+        w->slots[s].frames = 0;
+        atomic_init(&w->slots[s].state, WORKER_SLOT_FREE);
+    }
+    w->hold = buffers + (size_t)2 * capacity * 2;
+    w->capacity = capacity;
+    w->head = 0;
+    w->tail = 0;
+    w->xruns = 0;
+    w->run = run;
+    w->arg = arg;
+    atomic_init(&w->quit, 0);
+    if (sem_init(&w->wake, 0, 0) != 0) return -1;
+    if (pthread_create(&w->thread, NULL, Worker_Main, w) != 0) {
+        sem_destroy(&w->wake);
+        return -1;
+    }
+    Worker_Pin(w->thread);
+    w->running = 1;
+    return 0;
+}
+
+static void Worker_Stop(Worker *w) {
+    if (!w->running) return;
+    atomic_store_explicit(&w->quit, 1, memory_order_release);
+    sem_post(&w->wake);
+    pthread_join(w->thread, NULL);
+    sem_destroy(&w->wake);
+    w->running = 0;
+}
+
+#ifndef SPACECHO_REFERENCE_KERNEL  /* the reference build never offloads */
+/* Audio thread: queue this block and replace it with the one finished a block ago */
+static void Worker_Exchange(Worker *w, int16_t *audio, int frames) {
+    size_t bytes = (size_t)frames * 2 * sizeof(int16_t);
+    if (frames > w->capacity) {
+        memset(audio, 0, bytes);
+        w->xruns++;
+        return;
+    }
+
+    /* Collect the oldest finished block. When both are finished the worker
+     * ran late and caught up; drop the older to return to one block of latency. */
+    WorkerSlot *out = &w->slots[w->tail];
+    int state = atomic_load_explicit(&out->state, memory_order_acquire);
+    if (state == WORKER_SLOT_DONE &&
+        atomic_load_explicit(&w->slots[w->tail ^ 1].state, memory_order_acquire) == WORKER_SLOT_DONE) {
+        atomic_store_explicit(&out->state, WORKER_SLOT_FREE, memory_order_release);
+        w->tail ^= 1;
+        out = &w->slots[w->tail];
+        w->xruns++;
+    }
+    int outFrames = 0;
+    if (state == WORKER_SLOT_DONE) {
+        outFrames = out->frames < frames ? out->frames : frames;
+        memcpy(w->hold, out->audio, (size_t)outFrames * 2 * sizeof(int16_t));
+        atomic_store_explicit(&out->state, WORKER_SLOT_FREE, memory_order_release);
+        w->tail ^= 1;
+    } else if (state == WORKER_SLOT_QUEUED) {
+        w->xruns++;  /* still processing; a FREE slot is only the startup block */
+    }
+
+    /* Submit; with both slots still in flight the block is dropped */
+    WorkerSlot *in = &w->slots[w->head];
+    if (atomic_load_explicit(&in->state, memory_order_acquire) == WORKER_SLOT_FREE) {
+        memcpy(in->audio, audio, bytes);
+        in->frames = frames;
+        atomic_store_explicit(&in->state, WORKER_SLOT_QUEUED, memory_order_release);
+        w->head ^= 1;
+        sem_post(&w->wake);
+    } else {
+        w->xruns++;
+    }
+
+    memcpy(audio, w->hold, (size_t)outFrames * 2 * sizeof(int16_t));
+    memset(audio + outFrames * 2, 0, (size_t)(frames - outFrames) * 2 * sizeof(int16_t));
+}
+#endif
+
+/* ============================================================================
+ * PERF STATS - Optional hot-path instrumentation (-DSPACECHO_PERF_STATS)
+ *
+ * Each processed block is timestamped with the cycle counter (the generic
+ * timer on aarch64, CLOCK_MONOTONIC elsewhere) and its duration kept in a
+ * rolling window. The audio thread only writes; get_param("perf_stats")
+ * reads the window and counters from the control thread, so a report can be
+ * a block out of date but never blocks audio. Without the flag none of this
+ * is compiled in and perf_stats reports {"enabled":false}.
+ * ============================================================================ */
+
+#ifdef SPACECHO_PERF_STATS
+
+#define PERF_WINDOW 1024  /* blocks in the rolling window, power of two */
+
+typedef struct {
+    uint32_t blockNs[PERF_WINDOW];
+    atomic_uint blocks;         /* blocks processed since create */
+    atomic_int frames;          /* frames in the last block */
+    atomic_uint denormals;      /* blocks that ended with a subnormal filter state */
+    atomic_uint clips;          /* output samples beyond full scale */
+    atomic_uint ramps;          /* parameter ramps started */
+} PerfStats;
+
+static inline uint64_t perf_now(void) {
+#if defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline double perf_ticks_to_ns(uint64_t ticks) {
+#if defined(__aarch64__)
+    uint64_t freq;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    return (double)ticks * 1e9 / (double)freq;
+#else
+    return (double)ticks;
+#endif
+}
+
+static inline void PerfStats_Count(atomic_uint *counter, unsigned n) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+/* Audio thread: one block took (end - start) counter ticks */
+static void PerfStats_Record(PerfStats *ps, uint64_t start, uint64_t end, int frames) {
+    double ns = perf_ticks_to_ns(end - start);
+    unsigned block = atomic_load_explicit(&ps->blocks, memory_order_relaxed);
+    ps->blockNs[block & (PERF_WINDOW - 1)] = ns > 4e9 ? 0xFFFFFFFFu : (uint32_t)ns;
+    atomic_store_explicit(&ps->frames, frames, memory_order_relaxed);
+    atomic_store_explicit(&ps->blocks, block + 1, memory_order_release);
+}
+
+static int perf_compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Control thread: JSON report of the window and counters */
+static int PerfStats_Write(const PerfStats *ps, float sampleRate, uint32_t xruns, char *buf, int buf_len) {
+    unsigned blocks = atomic_load_explicit(&ps->blocks, memory_order_acquire);
+    int window = blocks < PERF_WINDOW ? (int)blocks : PERF_WINDOW;
+    uint32_t sorted[PERF_WINDOW];
+    memcpy(sorted, ps->blockNs, (size_t)window * sizeof(uint32_t));
+    qsort(sorted, (size_t)window, sizeof(uint32_t), perf_compare_u32);
+    double sum = 0.0;
+    for (int i = 0; i < window; i++) sum += sorted[i];
+
+    double minUs = window ? sorted[0] * 1e-3 : 0.0;
+    double maxUs = window ? sorted[window - 1] * 1e-3 : 0.0;
+    double avgUs = window ? sum / window * 1e-3 : 0.0;
+    double p99Us = window ? sorted[(window * 99) / 100 < window ? (window * 99) / 100 : window - 1] * 1e-3 : 0.0;
+    int frames = atomic_load_explicit(&ps->frames, memory_order_relaxed);
+    double budgetUs = frames > 0 ? frames * 1e6 / sampleRate : 0.0;
+
+    int len = snprintf(buf, buf_len,
+        "{\"enabled\":true,\"blocks\":%u,\"window\":%d,\"frames\":%d,"
+        "\"min_us\":%.2f,\"avg_us\":%.2f,\"p99_us\":%.2f,\"max_us\":%.2f,"
+        "\"load_avg\":%.4f,\"load_max\":%.4f,"
+        "\"denormals\":%u,\"clips\":%u,\"ramps\":%u,\"xruns\":%u}",
+        blocks, window, frames, minUs, avgUs, p99Us, maxUs,
+        budgetUs > 0.0 ? avgUs / budgetUs : 0.0, budgetUs > 0.0 ? maxUs / budgetUs : 0.0,
+        atomic_load_explicit(&ps->denormals, memory_order_relaxed),
+        atomic_load_explicit(&ps->clips, memory_order_relaxed),
+        atomic_load_explicit(&ps->ramps, memory_order_relaxed), xruns);
+    return len < buf_len ? len : -1;
+}
+
+#endif /* SPACECHO_PERF_STATS */
+
+/* ============================================================================
+ * PARAM KEYS - Interned parameter IDs and a perfect-hash key lookup
+ *
+ * Every key set_param/get_param understands has a fixed ID. Keys are hashed
+ * with seeded FNV-1a into PARAM_HASH_SIZE slots; param_keys_init picks the
+ * first seed (deterministically) for which no two keys collide, so a lookup
+ * is one hash, one slot and one strcmp to reject unknown keys. Hosts can
+ * resolve IDs once and use the numeric export instead of strings.
+ * ============================================================================ */
+
+enum {
+    TAP_FIELD_TIME = 0,
+    TAP_FIELD_DIVISION,
+    TAP_FIELD_GAIN,
+    TAP_FIELD_PAN,
+    TAP_FIELD_COUNT
+};
+
+enum {
+    /* Settable by ID (enum params take their option index) */
+    PARAM_TIME = 0,
+    PARAM_DIVISION,
+    PARAM_FEEDBACK,
+    PARAM_MIX,
+    PARAM_TONE,
+    PARAM_FLUTTER,
+    PARAM_WOW,
+    PARAM_STEREO_WIDTH,
+    PARAM_QUALITY,
+    PARAM_TIME_MODE,
+    PARAM_DRIVE,
+    PARAM_OVERSAMPLING,
+    PARAM_TAPS,
+    PARAM_FREEZE,
+    PARAM_PLAYBACK,
+    PARAM_DUCKING,
+    PARAM_TAP_FIRST,
+    PARAM_TAP_LAST = PARAM_TAP_FIRST + MAX_TAPS * TAP_FIELD_COUNT - 1,
+    PARAM_SETTABLE_COUNT,
+
+    /* String-only keys */
+    PARAM_BPM = PARAM_SETTABLE_COUNT,
+    PARAM_STATE,
+    PARAM_NAME,
+    PARAM_UI_HIERARCHY,
+    PARAM_CHAIN_PARAMS,
+    PARAM_STATE_BLOB,
+    PARAM_LATENCY,
+    PARAM_PERF_STATS,
+    PARAM_WIDTH_ALIAS,       /* "width" -> PARAM_STEREO_WIDTH */
+    PARAM_KEY_COUNT
+};
+
+#define PARAM_HASH_SIZE 256  /* power of two, > 4x the key count */
+#define PARAM_KEY_MAX 24
+
+static const char *tap_field_names[TAP_FIELD_COUNT] = { "time", "division", "gain", "pan" };
+
+static char g_param_keys[PARAM_KEY_COUNT][PARAM_KEY_MAX];
+static int16_t g_param_slots[PARAM_HASH_SIZE];
+static uint32_t g_param_seed;
+static pthread_once_t g_param_keys_once = PTHREAD_ONCE_INIT;
+
+static inline uint32_t param_hash(const char *key, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    while (*key) {
+        h ^= (uint8_t)*key++;
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+static void param_keys_build(void) {
+    static const char *named[] = {
+        [PARAM_TIME] = "time", [PARAM_DIVISION] = "division", [PARAM_FEEDBACK] = "feedback",
+        [PARAM_MIX] = "mix", [PARAM_TONE] = "tone", [PARAM_FLUTTER] = "flutter", [PARAM_WOW] = "wow",
+        [PARAM_STEREO_WIDTH] = "stereo_width", [PARAM_QUALITY] = "quality",
+        [PARAM_TIME_MODE] = "time_mode", [PARAM_DRIVE] = "drive",
+        [PARAM_OVERSAMPLING] = "oversampling", [PARAM_TAPS] = "taps", [PARAM_FREEZE] = "freeze",
+        [PARAM_PLAYBACK] = "playback", [PARAM_DUCKING] = "ducking",
+    };
+    static const char *special[] = {
+        [PARAM_BPM - PARAM_BPM] = "bpm", [PARAM_STATE - PARAM_BPM] = "state", [PARAM_NAME - PARAM_BPM] = "name",
+        [PARAM_UI_HIERARCHY - PARAM_BPM] = "ui_hierarchy", [PARAM_CHAIN_PARAMS - PARAM_BPM] = "chain_params",
+        [PARAM_STATE_BLOB - PARAM_BPM] = "state_blob", [PARAM_LATENCY - PARAM_BPM] = "latency",
+        [PARAM_PERF_STATS - PARAM_BPM] = "perf_stats",
+        [PARAM_WIDTH_ALIAS - PARAM_BPM] = "width",
+    };
+    for (int id = 0; id < PARAM_KEY_COUNT; id++) {
+        if (id < PARAM_TAP_FIRST) {
+            snprintf(g_param_keys[id], PARAM_KEY_MAX, "%s", named[id]);
+        } else if (id <= PARAM_TAP_LAST) {
+            int tap = (id - PARAM_TAP_FIRST) / TAP_FIELD_COUNT;
+            int field = (id - PARAM_TAP_FIRST) % TAP_FIELD_COUNT;
+            snprintf(g_param_keys[id], PARAM_KEY_MAX, "tap%d_%s", tap + 1, tap_field_names[field]);
+        } else {
+            snprintf(g_param_keys[id], PARAM_KEY_MAX, "%s", special[id - PARAM_BPM]);
+        }
+    }
+
+    /* Search for a collision-free seed */
+    for (uint32_t seed = 0;; seed++) {
+        int collided = 0;
+        for (int k = 0; k < PARAM_HASH_SIZE; k++) g_param_slots[k] = -1;
+        for (int id = 0; id < PARAM_KEY_COUNT && !collided; id++) {
+            uint32_t slot = param_hash(g_param_keys[id], seed) & (PARAM_HASH_SIZE - 1);
+            if (g_param_slots[slot] >= 0) collided = 1;
+            else g_param_slots[slot] = (int16_t)id;
+        }
+        if (!collided) {
+            g_param_seed = seed;
+            break;
+        }
+    }
+}
+
+/* Any thread: intern the keys and pick the hash seed once (the dlsym
+ * param_id export can run before or alongside move_audio_fx_init_v2) */
+static void param_keys_init(void) {
+    pthread_once(&g_param_keys_once, param_keys_build);
+}
+
+/* Key to ID, or -1 for unknown keys */
+static int param_key_id(const char *key) {
+    int id = g_param_slots[param_hash(key, g_param_seed) & (PARAM_HASH_SIZE - 1)];
+    if (id < 0 || strcmp(g_param_keys[id], key) != 0) return -1;
+    return id == PARAM_WIDTH_ALIAS ? PARAM_STEREO_WIDTH : id;
+}
+
+/* Labels of an enum param (count in *count), NULL for numeric params */
+static const char *const *param_options(int id, int *count) {
+    if (id == PARAM_DIVISION ||
+        (id >= PARAM_TAP_FIRST && id <= PARAM_TAP_LAST &&
+         (id - PARAM_TAP_FIRST) % TAP_FIELD_COUNT == TAP_FIELD_DIVISION)) {
+        *count = DIV_COUNT;
+        return division_names;
+    }
+    switch (id) {
+    case PARAM_QUALITY: *count = INTERP_COUNT; return interp_names;
+    case PARAM_TIME_MODE: *count = TIME_MODE_COUNT; return time_mode_names;
+    case PARAM_OVERSAMPLING: *count = OVERSAMPLING_COUNT; return oversampling_names;
+    case PARAM_FREEZE: *count = FREEZE_COUNT; return freeze_names;
+    case PARAM_PLAYBACK: *count = PLAYBACK_COUNT; return playback_names;
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * JSON HELPERS - Minimal key lookup and tokenizer primitives
+ * ============================================================================ */
+
+static inline const char *json_skip_ws(const char *p) {
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+    return p;
+}
+
+/* Parse a JSON number at p, returning the end or NULL. Plain decimals are
+ * converted from an integer mantissa; exponents fall back to strtof. */
+static const char *json_parse_number(const char *p, float *out) {
+    static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+                                    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+    const char *start = p;
+    int neg = (*p == '-');
+    if (neg) p++;
+    if (*p < '0' || *p > '9') return NULL;
+
+    uint64_t mant = 0;
+    int digits = 0, frac = 0;
+    while (*p >= '0' && *p <= '9') { mant = mant * 10 + (uint64_t)(*p++ - '0'); digits++; }
+    if (*p == '.') {
+        p++;
+        while (*p >= '0' && *p <= '9') { mant = mant * 10 + (uint64_t)(*p++ - '0'); digits++; frac++; }
+    }
+    if (*p == 'e' || *p == 'E' || digits > 18) {
+        char *end;
+        *out = strtof(start, &end);
+        return end;
+    }
+    double v = (double)mant / pow10[frac];
+    *out = (float)(neg ? -v : v);
+    return p;
+}
+
+/* Copy a JSON string at p (opening quote) into out, returning the end or NULL.
+ * Escapes are not decoded; state values never contain them. */
+static const char *json_parse_string(const char *p, char *out, int out_len) {
+    if (*p != '"') return NULL;
+    p++;
+    int i = 0;
+    while (*p && *p != '"') {
+        if (*p == '\\' && p[1]) p++;
+        if (i < out_len - 1) out[i++] = *p;
+        p++;
+    }
+    out[i] = '\0';
+    return *p == '"' ? p + 1 : NULL;
+}
+
+/* Skip any JSON value (nested objects/arrays included), returning the end or NULL */
+static const char *json_skip_value(const char *p) {
+    int depth = 0;
+    while (*p) {
+        if (*p == '"') {
+            p++;
+            while (*p && *p != '"') p += (*p == '\\' && p[1]) ? 2 : 1;
+            if (!*p) return NULL;
+        } else if (*p == '{' || *p == '[') {
+            depth++;
+        } else if (*p == '}' || *p == ']') {
+            if (depth == 0) return p;
+            depth--;
+        } else if (*p == ',' && depth == 0) {
+            return p;
+        }
+        p++;
+    }
+    return depth == 0 ? p : NULL;
+}
+
+/* Helper to extract a JSON boolean (true/false or 0/1) by key, 0 if absent */
+static int json_get_flag(const char *json, const char *key) {
+    char search[64];
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    const char *pos = strstr(json, search);
+    if (!pos) return 0;
+    pos += strlen(search);
+    while (*pos == ' ') pos++;
+    if (strncmp(pos, "true", 4) == 0) return 1;
+    return atof(pos) != 0.0;
+}
+
+/* Helper to extract a JSON number by key, fallback if absent */
+static float json_get_number(const char *json, const char *key, float fallback) {
+    char search[64];
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    const char *pos = strstr(json, search);
+    if (!pos) return fallback;
+    return (float)atof(pos + strlen(search));
+}
+
+/* Helper to match a JSON string by key against option names, fallback if
+ * absent or unknown */
+static int json_get_option(const char *json, const char *key, const char *const *names, int count,
+                           int fallback) {
+    char search[64];
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    const char *pos = strstr(json, search);
+    if (!pos) return fallback;
+    pos += strlen(search);
+    while (*pos == ' ') pos++;
+    if (*pos++ != '"') return fallback;
+    for (int i = 0; i < count; i++) {
+        size_t len = strlen(names[i]);
+        if (strncmp(pos, names[i], len) == 0 && pos[len] == '"') return i;
+    }
+    return fallback;
+}
+
+/* ============================================================================
+ * STATE - Single-pass JSON state parser and versioned binary state blob
+ *
+ * Both formats decode into StateFields (one value per settable param ID plus
+ * bpm, and a presence mask), which the instance applies in ID order. The JSON
+ * is walked once: each key is resolved through the param hash and its value
+ * parsed in place. The blob is a fixed little-endian layout, exchanged as
+ * base64 text through the "state_blob" key (or "state", which accepts both).
+ * ============================================================================ */
+
+#define PARAM_STATE_FIELDS (PARAM_BPM + 1)
+
+_Static_assert(PARAM_STATE_FIELDS <= 64, "state presence mask is 64 bits");
+
+typedef struct {
+    float value[PARAM_STATE_FIELDS];  /* enum params hold their option index */
+    uint64_t present;
+} StateFields;
+
+static inline void StateFields_Set(StateFields *st, int id, float v) {
+    st->value[id] = v;
+    st->present |= 1ull << id;
+}
+
+static inline int StateFields_Has(const StateFields *st, int id) {
+    return (int)((st->present >> id) & 1u);
+}
+
+/* Fields a state carries; freeze is a performance control and never restored */
+static inline int param_in_state(int id) {
+    return id >= 0 && id < PARAM_STATE_FIELDS && id != PARAM_FREEZE;
+}
+
+static inline int param_is_division(int id) {
+    return id == PARAM_DIVISION ||
+           (id >= PARAM_TAP_FIRST && id <= PARAM_TAP_LAST &&
+            (id - PARAM_TAP_FIRST) % TAP_FIELD_COUNT == TAP_FIELD_DIVISION);
+}
+
+/* Walk a state object once. Unknown keys and values are skipped. */
+static int state_parse_json(const char *json, StateFields *st) {
+    const char *p = json_skip_ws(json);
+    if (*p++ != '{') return -1;
+    st->present = 0;
+
+    for (;;) {
+        p = json_skip_ws(p);
+        if (*p == '}') return 0;
+
+        char key[PARAM_KEY_MAX];
+        p = json_parse_string(p, key, sizeof(key));
+        if (!p) return -1;
+        p = json_skip_ws(p);
+        if (*p++ != ':') return -1;
+        p = json_skip_ws(p);
+
+        int id = param_key_id(key);
+        float v;
+        const char *end = NULL;
+        if (param_in_state(id)) {
+            if (*p == '"') {
+                char str[16];
+                end = json_parse_string(p, str, sizeof(str));
+                int count;
+                const char *const *names = param_options(id, &count);
+                if (end && names) StateFields_Set(st, id, (float)parse_option(str, names, count));
+            } else {
+                end = json_parse_number(p, &v);
+                if (end) StateFields_Set(st, id, v);
+            }
+        }
+        if (!end) end = json_skip_value(p);
+        if (!end) return -1;
+
+        p = json_skip_ws(end);
+        if (*p == ',') p++;
+        else if (*p != '}') return -1;
+    }
+}
+
+/*
+ * Binary state, version 1. Newer versions may only append fields: a loader
+ * reads the prefix it knows and treats fields past blob.size as absent.
+ */
+#define STATE_BLOB_MAGIC 0x31434553u  /* "SEC1" */
+#define STATE_BLOB_VERSION 1
+
+typedef struct {
+    int16_t time;
+    uint8_t division;
+    uint8_t reserved;
+    float gain;
+    float pan;
+} StateBlobTap;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;          /* bytes of blob data that follow from magic on */
+    float feedback;
+    float mix;
+    float tone;
+    float flutter;
+    float wow;
+    int16_t time;
+    int16_t stereo_width;
+    int16_t bpm;
+    uint8_t division;
+    uint8_t quality;
+    uint8_t taps;
+    uint8_t reserved[3];
+    StateBlobTap tap[MAX_TAPS];
+    /* Appended fields (absent when size is smaller) */
+    float bpm_exact;        /* fractional MIDI clock tempo (bpm is rounded) */
+    uint8_t time_mode;
+    uint8_t reserved2[3];
+    float drive;
+    uint8_t oversampling;
+    uint8_t reserved3[3];
+    uint8_t playback;
+    uint8_t reserved4[3];
+    float ducking;
+} StateBlob;
+
+#define STATE_BLOB_V1_SIZE ((int)offsetof(StateBlob, bpm_exact))
+#define STATE_BLOB_HAS(blob, field) ((blob).size >= offsetof(StateBlob, field) + sizeof((blob).field))
+
+_Static_assert(sizeof(StateBlob) == 64 + 12 * MAX_TAPS, "state blob layout must not pad");
+
+#define STATE_BLOB_TEXT_MAX (((int)sizeof(StateBlob) + 2) / 3 * 4 + 1)
+
+static const char base64_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static int base64_encode(const uint8_t *in, int n, char *out, int out_len) {
+    int len = (n + 2) / 3 * 4;
+    if (len >= out_len) return -1;
+    char *o = out;
+    for (int i = 0; i < n; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < n) v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < n) v |= in[i + 2];
+        *o++ = base64_chars[(v >> 18) & 63];
+        *o++ = base64_chars[(v >> 12) & 63];
+        *o++ = i + 1 < n ? base64_chars[(v >> 6) & 63] : '=';
+        *o++ = i + 2 < n ? base64_chars[v & 63] : '=';
+    }
+    *o = '\0';
+    return len;
+}
+
+/* Decode base64 text into out, returning the byte count or -1 */
+static int base64_decode(const char *in, uint8_t *out, int out_len) {
+    uint32_t acc = 0;
+    int bits = 0, n = 0;
+    for (; *in && *in != '='; in++) {
+        int c = *in;
+        int v = (c >= 'A' && c <= 'Z') ? c - 'A' :
+                (c >= 'a' && c <= 'z') ? c - 'a' + 26 :
+                (c >= '0' && c <= '9') ? c - '0' + 52 :
+                c == '+' ? 62 : c == '/' ? 63 : -1;
+        if (v < 0) return -1;
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (n >= out_len) return -1;
+            out[n++] = (uint8_t)(acc >> bits);
+        }
+    }
+    return n;
+}
+
+static int state_parse_blob(const char *text, StateFields *st) {
+    uint8_t bytes[sizeof(StateBlob) + 64];
+    int n = base64_decode(json_skip_ws(text), bytes, sizeof(bytes));
+    if (n < STATE_BLOB_V1_SIZE) return -1;
+
+    /* Read the known prefix; newer blobs may carry fields we skip */
+    StateBlob blob;
+    memset(&blob, 0, sizeof(blob));
+    memcpy(&blob, bytes, n < (int)sizeof(blob) ? (size_t)n : sizeof(blob));
+    if (blob.magic != STATE_BLOB_MAGIC || blob.version < 1 ||
+        blob.size < STATE_BLOB_V1_SIZE || blob.size > n) return -1;
+
+    st->present = 0;
+    StateFields_Set(st, PARAM_TIME, blob.time);
+    StateFields_Set(st, PARAM_DIVISION, blob.division);
+    StateFields_Set(st, PARAM_FEEDBACK, blob.feedback);
+    StateFields_Set(st, PARAM_MIX, blob.mix);
+    StateFields_Set(st, PARAM_TONE, blob.tone);
+    StateFields_Set(st, PARAM_FLUTTER, blob.flutter);
+    StateFields_Set(st, PARAM_WOW, blob.wow);
+    StateFields_Set(st, PARAM_STEREO_WIDTH, blob.stereo_width);
+    StateFields_Set(st, PARAM_QUALITY, blob.quality);
+    StateFields_Set(st, PARAM_TAPS, blob.taps);
+    StateFields_Set(st, PARAM_BPM, STATE_BLOB_HAS(blob, bpm_exact) ? blob.bpm_exact : blob.bpm);
+    if (STATE_BLOB_HAS(blob, time_mode)) StateFields_Set(st, PARAM_TIME_MODE, blob.time_mode);
+    if (STATE_BLOB_HAS(blob, drive)) StateFields_Set(st, PARAM_DRIVE, blob.drive);
+    if (STATE_BLOB_HAS(blob, oversampling)) StateFields_Set(st, PARAM_OVERSAMPLING, blob.oversampling);
+    if (STATE_BLOB_HAS(blob, playback)) StateFields_Set(st, PARAM_PLAYBACK, blob.playback);
+    if (STATE_BLOB_HAS(blob, ducking)) StateFields_Set(st, PARAM_DUCKING, blob.ducking);
+    int taps = blob.taps < MAX_TAPS ? blob.taps : MAX_TAPS;
+    for (int t = 0; t < taps; t++) {
+        const int first = PARAM_TAP_FIRST + t * TAP_FIELD_COUNT;
+        StateFields_Set(st, first + TAP_FIELD_TIME, blob.tap[t].time);
+        StateFields_Set(st, first + TAP_FIELD_DIVISION, blob.tap[t].division);
+        StateFields_Set(st, first + TAP_FIELD_GAIN, blob.tap[t].gain);
+        StateFields_Set(st, first + TAP_FIELD_PAN, blob.tap[t].pan);
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * V2 API - Instance-based
+ * ============================================================================ */
+
+#define AUDIO_FX_API_VERSION_2 2
+
+typedef struct audio_fx_api_v2 {
+    uint32_t api_version;
+    void* (*create_instance)(const char *module_dir, const char *config_json);
+    void (*destroy_instance)(void *instance);
+    void (*process_block)(void *instance, int16_t *audio_inout, int frames);
     void (*set_param)(void *instance, const char *key, const char *val);
     int (*get_param)(void *instance, const char *key, char *buf, int buf_len);
 } audio_fx_api_v2_t;
 
-/* Instance structure */
+/* ============================================================================
+ * MAPPED I/O - Zero-copy blocks straight from the host's shared mailbox
+ *
+ * module.json advertises "mapped_io": true under capabilities. A host that
+ * honours it may call process_block with audio_inout == NULL: the block is
+ * then read from mapped_memory + audio_in_offset and written to
+ * mapped_memory + audio_out_offset (in place when the offsets are equal),
+ * saving the host's copy into its own buffer when the plugin is last in the
+ * chain.
+ *
+ * Alignment: each region must be int16-aligned (even offsets). The NEON
+ * kernel moves audio with vld2q_s16/vst2q_s16, which AArch64 allows at any
+ * element alignment; 16-byte aligned offsets (Move uses 256 and 2304 into a
+ * page-aligned mapping) keep every 8-frame access within one cache line. The
+ * two regions must not partially overlap, and a block may not exceed
+ * MOVE_AUDIO_BYTES_PER_BLOCK.
+ * ============================================================================ */
+
+typedef struct {
+    const int16_t *in;   /* NULL when the host offers no usable mapping */
+    int16_t *out;
+    int maxFrames;
+} MappedIo;
+
+static void MappedIo_Init(MappedIo *m, const host_api_v1_t *host) {
+    memset(m, 0, sizeof(*m));
+    if (!host || !host->mapped_memory || host->audio_in_offset < 0 || host->audio_out_offset < 0) return;
+    if ((host->audio_in_offset | host->audio_out_offset) & 1) {
+        plugin_log("mapped_io: audio offsets not int16-aligned, mapped blocks ignored");
+        return;
+    }
+    int gap = abs(host->audio_in_offset - host->audio_out_offset);
+    if (gap != 0 && gap < MOVE_AUDIO_BYTES_PER_BLOCK) {
+        plugin_log("mapped_io: audio regions overlap, mapped blocks ignored");
+        return;
+    }
+    m->in = (const int16_t *)(host->mapped_memory + host->audio_in_offset);
+    m->out = (int16_t *)(host->mapped_memory + host->audio_out_offset);
+    m->maxFrames = MOVE_AUDIO_BYTES_PER_BLOCK / (2 * (int)sizeof(int16_t));
+}
+
+/* Resolve a NULL block to the mapped regions; returns 0 if it cannot be served */
+static inline int MappedIo_Resolve(const MappedIo *m, int16_t *audio_inout, int frames,
+                                   const int16_t **in, int16_t **out) {
+    if (audio_inout) {
+        *in = *out = audio_inout;
+        return 1;
+    }
+    if (!m->in || frames > m->maxFrames) return 0;
+    *in = m->in;
+    *out = m->out;
+    return 1;
+}
+
+/* Output a chunk unchanged from its input */
+static inline void kernel_pass_through(const int16_t *in, int16_t *out, int n) {
+    if (in != out) memcpy(out, in, (size_t)n * 2 * sizeof(int16_t));
+}
+
+/* Instance structure */
+typedef struct {
+    Arena arena;           /* owns this struct and scratch */
+    char module_dir[256];
+
+    /* Delay line (interleaved L/R) and filters */
+    StereoDelayLine delayLine;
+    DelayGrowth delayGrowth;   /* owns the delay buffer */
+    OnePoleFilter toneFilter[MAX_CHANNELS];
+    float allpassState[MAX_CHANNELS];  /* main head allpass interpolator */
+
+    /* Jump-mode crossfade: the old head keeps reading at fadeFromSamples */
+    int timeMode;              /* audio thread's copy of param_time_mode */
+    float fadeFromSamples;     /* old head delay while fading */
+    int fadeFrames;            /* JUMP_FADE_SECONDS at sampleRate */
+    int fadeRemaining;         /* frames left in the current crossfade, 0 = none */
+    float fadePending;         /* jump target (seconds) queued behind the fade, < 0 = none */
+    float fadeAllpassState[MAX_CHANNELS];
+
+    /* Tape flutter/wow modulation of every read head */
+    FlutterLFO flutter;
+
+    /* Multi-tap heads (activeTaps in use) and the tap bus tone filter */
+    DelayTap taps[MAX_TAPS];
+    int activeTaps;        /* audio thread's copy of param_taps */
+    int frozen;            /* audio thread's copy of param_freeze */
+    int freezeLength;      /* loop frames ending at the (held) write position */
+    int freezeCursor;      /* next loop frame to play */
+
+    /* Reverse / varispeed grains; grain.mode is the audio thread's copy of param_playback */
+    PlaybackGrain grain;       /* grain playing now */
+    PlaybackGrain grainOld;    /* previous grain (or the forward head), fading out */
+    int grainLength;           /* frames in the current grain */
+    int grainFadeFrames;       /* GRAIN_FADE_SECONDS at sampleRate */
+    int grainFade;             /* length of the running grain crossfade */
+    int grainFadeRemaining;    /* frames left in it, 0 = none */
+    OnePoleFilter tapToneFilter[MAX_CHANNELS];
+    ToneTable toneTable;   /* b1 over tone 0-1 at this sample rate */
+    DuckFollower duck;     /* dry input envelope to wet gain */
+
+    /* Smoothed values */
+    SmoothedValue smoothedDelayTime;
+    SmoothedValue smoothedFeedback;
+    SmoothedValue smoothedDrive;   /* saturation gain, 1 = off */
+    SmoothedValue smoothedMix;
+    SmoothedValue smoothedTone;
+    SmoothedValue smoothedStereoWidth;
+
+    /* Parameters */
+    int param_time;        /* milliseconds (20-2000) */
+    float param_feedback;
+    float param_drive;     /* 0-1, feedback saturation drive (0 = clean) */
+    int param_oversampling; /* Oversampling of the saturation stage */
+    float param_mix;
+    float param_tone;
+    int param_stereo_width; /* percent (0=mono, 100=full L/R) */
+    int param_division;    /* DIV_FREE..DIV_16T */
+    float param_bpm;       /* detected BPM from MIDI clock (40-300, fractional) */
+    int param_taps;        /* active multi-tap heads (0 = single head only) */
+    int param_freeze;      /* FreezeMode: loop the delay content, no writes */
+    int param_playback;    /* PlaybackMode of the main head */
+    float param_ducking;   /* 0-1, wet attenuation under the dry input (0 = off) */
+    float param_flutter;   /* 0-1, ~5Hz flutter depth */
+    float param_wow;       /* 0-1, ~0.5Hz wow depth */
+    int param_quality;     /* InterpMode of every read head */
+    int param_time_mode;   /* TimeMode of the main head */
+
+    /* MIDI clock detection */
+    int64_t clock_sample_pos;  /* samples processed since create, tick time base */
+    TempoTracker tempo;        /* least-squares fit over recent tick positions */
+    int clock_running;         /* received enough ticks to derive BPM */
+    float clock_bpm;           /* last tempo the clock published */
+    uint32_t clock_seq;        /* tempo publications so far */
+
+    /* Tempo sync: each side keeps its own copy of the published clock tempo */
+    uint32_t clockSeen;        /* set_param side: last publication taken into param_bpm */
+    float syncBpm;             /* audio thread's tempo for the synced heads */
+    int syncDivision;          /* audio thread's copy of param_division */
+    uint32_t syncSeen;         /* audio thread: last publication applied */
+
+    /* Tail tracking for lazy bypass */
+    float tailPeak;            /* peak |sample| written into the delay line, last chunk */
+    int tailSilentFrames;      /* consecutive frames written below TAIL_SILENCE_THRESHOLD */
+
+    /* Host audio format, picked up at create time */
+    float sampleRate;
+    int rampSamples;           /* RAMP_SECONDS at sampleRate */
+    int chunkFrames;           /* block kernel frames per pass */
+
+    /* Block kernel scratch (planar, chunkFrames each, carved from the arena) */
+    float *scratch;
+    float *scratchInL;
+    float *scratchInR;
+    float *scratchWetL;
+    float *scratchWetR;
+    float *scratchWriteL;
+    float *scratchWriteR;
+    float *scratchDelay;
+    float *scratchFeedback;
+    float *scratchDrive;       /* saturation gain while drive ramps */
+    float *scratchMix;
+    float *scratchWidth;
+    float *scratchTapL;
+    float *scratchTapR;
+    float *scratchMod;         /* flutter/wow delay offset, seconds */
+    float *scratchTone;        /* tone filter pole (b1) while tone ramps */
+    float *scratchFadeL;       /* old head output during a jump crossfade */
+    float *scratchFadeR;
+    float *scratchFadeIn;      /* new / old head crossfade gains */
+    float *scratchFadeOut;
+    float *scratchFadeDelay;   /* old head delay (seconds) when modulated */
+    float *scratchGrainL;      /* fading-out grain output */
+    float *scratchGrainR;
+    float *scratchDuck;        /* per-frame wet gain while ducking */
+    float *scratchSpanL;       /* grain source span, 2 * chunkFrames each */
+    float *scratchSpanR;
+
+    /* Oversampled saturation (filter state per channel and stage, scratch from the arena) */
+    int oversampling;          /* audio thread's copy of param_oversampling */
+    HalfBandState halfband[MAX_CHANNELS][2];
+    float *osWorkEven;         /* HALFBAND_HISTORY + 1 + 2 * chunkFrames each */
+    float *osWorkOdd;
+    float *osRate2;            /* 2 * chunkFrames */
+    float *osRate4;            /* 4 * chunkFrames */
+    float *osGain;             /* drive gain at the oversampled rate while ramping */
+
+    /* set_param -> audio thread */
+    ParamQueue paramQueue;
+    /* MIDI clock -> audio thread (or the worker) and set_param, clock_tempo_pack */
+    _Atomic uint64_t clockTempo;
+
+    /* Optional offload of the whole kernel, one block of latency */
+    Worker worker;
+
+    /* Host mailbox regions for audio_inout == NULL blocks */
+    MappedIo mapped;
+    /* int16 block for process_block_f32 through the worker or reference kernel */
+    int16_t *bridge;
+    int bridgeFrames;
+
+#ifdef SPACECHO_PERF_STATS
+    PerfStats perf;
+#endif
+
+    int initialized;
+} spacecho_instance_t;
+
+/* Tone filter pole on the main head and the tap bus */
+static void set_tone_pole(spacecho_instance_t *inst, float b1) {
+    for (int ch = 0; ch < MAX_CHANNELS; ch++) {
+        OnePoleFilter_SetPole(&inst->toneFilter[ch], b1);
+        OnePoleFilter_SetPole(&inst->tapToneFilter[ch], b1);
+    }
+}
+
+/* Delay buffer length a head at 'seconds' needs, modulation included */
+static int delay_length_for(const spacecho_instance_t *inst, float seconds) {
+    return StereoDelayLine_LengthFor(seconds + MAX_MODULATION_SECONDS, inst->sampleRate);
+}
+
+static void kernel_run_block(void *instance, int16_t *audio_inout, int frames);
+
+/* Create time: record the defaults as the latest events, so a resync before
+ * the first set_param of each kind replays them */
+static void record_default_params(spacecho_instance_t *inst) {
+    const struct { int type; float a, b; } globals[] = {
+        { PARAM_EVENT_TIME_MODE, (float)inst->param_time_mode, 0.0f },
+        { PARAM_EVENT_DELAY_TIME, GetDelayTimeSeconds(inst->param_time), 0.0f },
+        { PARAM_EVENT_FEEDBACK, GetFeedback(inst->param_feedback, inst->param_drive), 0.0f },
+        { PARAM_EVENT_DRIVE, GetDriveGain(inst->param_drive), 0.0f },
+        { PARAM_EVENT_OVERSAMPLING, (float)inst->param_oversampling, 0.0f },
+        { PARAM_EVENT_MIX, inst->param_mix, 0.0f },
+        { PARAM_EVENT_TONE, inst->param_tone, 0.0f },
+        { PARAM_EVENT_WIDTH, GetStereoWidth(inst->param_stereo_width), 0.0f },
+        { PARAM_EVENT_MODULATION, inst->param_flutter, inst->param_wow },
+        { PARAM_EVENT_QUALITY, (float)inst->param_quality, 0.0f },
+        { PARAM_EVENT_TAPS, (float)inst->param_taps, 0.0f },
+        { PARAM_EVENT_FREEZE, (float)inst->param_freeze, 0.0f },
+        { PARAM_EVENT_PLAYBACK, (float)inst->param_playback, 0.0f },
+        { PARAM_EVENT_DUCKING, inst->param_ducking, 0.0f },
+        { PARAM_EVENT_DIVISION, (float)inst->param_division, 0.0f },
+        { PARAM_EVENT_BPM, inst->param_bpm, 0.0f },
+    };
+    ParamEvent ev = {0};
+    for (size_t k = 0; k < sizeof(globals) / sizeof(globals[0]); k++) {
+        ev.type = (uint8_t)globals[k].type;
+        ev.a = globals[k].a;
+        ev.b = globals[k].b;
+        ParamQueue_Record(&inst->paramQueue, &ev);
+    }
+    for (int t = 0; t < MAX_TAPS; t++) {
+        const DelayTap *tap = &inst->taps[t];
+        ev.tap = (uint8_t)t;
+        ev.type = PARAM_EVENT_TAP_TIME;
+        ev.a = GetDelayTimeSeconds(tap->param_time);
+        ev.b = 0.0f;
+        ParamQueue_Record(&inst->paramQueue, &ev);
+        ev.type = PARAM_EVENT_TAP_GAINS;
+        DelayTap_PanGains(tap, &ev.a, &ev.b);
+        ParamQueue_Record(&inst->paramQueue, &ev);
+        ev.type = PARAM_EVENT_TAP_DIVISION;
+        ev.a = (float)tap->param_division;
+        ev.b = 0.0f;
+        ParamQueue_Record(&inst->paramQueue, &ev);
+    }
+}
+
+static void* v2_create_instance(const char *module_dir, const char *config_json) {
+    plugin_log("Creating instance");
+
+    /* Audio format from the host, falling back to Move defaults */
+    int sample_rate = (g_host && g_host->sample_rate > 0) ? g_host->sample_rate : MOVE_SAMPLE_RATE;
+    int block_frames = (g_host && g_host->frames_per_block > 0) ? g_host->frames_per_block : MOVE_FRAMES_PER_BLOCK;
+    float sampleRate = (float)sample_rate;
+
+    /* The kernel reads a chunk before writing it, so a chunk must be
+     * shorter than the minimum (modulated) delay; longer host blocks are split. */
+    int max_chunk = (int)((MIN_DELAY_SECONDS - MAX_MODULATION_SECONDS) * sampleRate) - INTERP_LOOKAHEAD;
+    int chunkFrames = block_frames < max_chunk ? block_frames : max_chunk;
+    if (chunkFrames < 1) chunkFrames = 1;
+
+    /* Optional memory placement from module.json defaults */
+    int lock_memory = config_json ? json_get_flag(config_json, "lock_memory") : 0;
+    int huge_pages = config_json ? json_get_flag(config_json, "huge_pages") : 0;
+    int worker_thread = config_json ? json_get_flag(config_json, "worker_thread") : 0;
+    int delay_storage = config_json ? json_get_option(config_json, "delay_storage", delay_storage_names,
+                                                      DELAY_STORAGE_COUNT, DELAY_STORAGE_FLOAT)
+                                    : DELAY_STORAGE_FLOAT;
+#ifdef SPACECHO_REFERENCE_KERNEL
+    worker_thread = 0;
+#endif
+
+    /* Instance, kernel scratch and worker slots share one arena */
+    size_t scratch_bytes = (size_t)chunkFrames * (KERNEL_SCRATCH_BUFFERS + 2 * KERNEL_SPAN_BUFFERS) * sizeof(float);
+    size_t os_bytes = (size_t)(2 * (HALFBAND_HISTORY + 1) + 14 * chunkFrames) * sizeof(float);
+    size_t worker_bytes = worker_thread ? Worker_BufferBytes(block_frames) : 0;
+    size_t bridge_bytes = (size_t)block_frames * 2 * sizeof(int16_t);
+    Arena arena;
+    if (Arena_Create(&arena, Arena_AlignUp(sizeof(spacecho_instance_t)) + Arena_AlignUp(scratch_bytes) +
+                             Arena_AlignUp(os_bytes) + Arena_AlignUp(worker_bytes) + Arena_AlignUp(bridge_bytes),
+                     huge_pages) != 0) {
+        plugin_log("Failed to allocate instance");
+        return NULL;
+    }
+    spacecho_instance_t *inst = (spacecho_instance_t*)Arena_Alloc(&arena, sizeof(spacecho_instance_t));
+    inst->scratch = (float *)Arena_Alloc(&arena, scratch_bytes);
+    inst->osWorkEven = (float *)Arena_Alloc(&arena, os_bytes);
+    int16_t *worker_buffers = worker_thread ? (int16_t *)Arena_Alloc(&arena, worker_bytes) : NULL;
+    inst->bridge = (int16_t *)Arena_Alloc(&arena, bridge_bytes);
+    inst->bridgeFrames = block_frames;
+    inst->arena = arena;
+
+    if (lock_memory && Arena_Lock(&inst->arena) != 0) {
+        plugin_log("mlock failed, instance memory left pageable");
+    }
+
+    if (module_dir) {
+        strncpy(inst->module_dir, module_dir, sizeof(inst->module_dir) - 1);
+    }
+
+    /* Set default parameters */
+    inst->param_time = 400;  /* 400ms */
+    inst->param_feedback = 0.4f;
+    inst->param_mix = 0.5f;
+    inst->param_tone = 0.5f;
+    inst->param_stereo_width = 0;
+    inst->param_flutter = 0.0f;
+    inst->param_wow = 0.0f;
+    inst->param_quality = INTERP_LINEAR;
+    inst->param_division = DIV_FREE;
+    inst->param_bpm = 120.0f;
+    inst->clock_bpm = inst->syncBpm = inst->param_bpm;
+    inst->syncDivision = DIV_FREE;
+
+    inst->sampleRate = sampleRate;
+    inst->rampSamples = (int)(RAMP_SECONDS * sampleRate + 0.5f);
+    inst->fadeFrames = (int)(JUMP_FADE_SECONDS * sampleRate + 0.5f);
+    inst->grainFadeFrames = (int)(GRAIN_FADE_SECONDS * sampleRate + 0.5f);
+    inst->fadePending = -1.0f;
+    inst->chunkFrames = chunkFrames;
+
+    /* Delay buffer sized for max_delay_ms (default: the initial time), grown on demand */
+    int max_delay_ms = (int)(config_json ? json_get_number(config_json, "max_delay_ms", (float)inst->param_time)
+                                         : (float)inst->param_time);
+    int max_length = delay_length_for(inst, MAX_DELAY_SECONDS);
+    if (DelayGrowth_Init(&inst->delayGrowth, delay_length_for(inst, GetDelayTimeSeconds(max_delay_ms)),
+                         max_length, delay_storage_frame_bytes(delay_storage), huge_pages, lock_memory) != 0) {
+        plugin_log("Failed to allocate delay buffer");
+        Arena_Release(&inst->arena);
+        return NULL;
+    }
+
+    /* Initialize delay line, kernel scratch and filters */
+    StereoDelayLine_Init(&inst->delayLine, inst->sampleRate, inst->delayGrowth.current.base,
+                         inst->delayGrowth.capacity, delay_storage);
+    inst->tailSilentFrames = inst->delayLine.bufferLength;  /* buffer starts zeroed */
+    {
+        float **planes[KERNEL_SCRATCH_BUFFERS] = {
+            &inst->scratchInL, &inst->scratchInR, &inst->scratchWetL, &inst->scratchWetR,
+            &inst->scratchWriteL, &inst->scratchWriteR, &inst->scratchDelay,
+            &inst->scratchFeedback, &inst->scratchDrive, &inst->scratchMix, &inst->scratchWidth,
+            &inst->scratchTapL, &inst->scratchTapR, &inst->scratchMod,
+            &inst->scratchTone, &inst->scratchFadeL, &inst->scratchFadeR,
+            &inst->scratchFadeIn, &inst->scratchFadeOut, &inst->scratchFadeDelay,
+            &inst->scratchGrainL, &inst->scratchGrainR, &inst->scratchDuck
+        };
+        for (int k = 0; k < KERNEL_SCRATCH_BUFFERS; k++) {
+            *planes[k] = inst->scratch + (size_t)k * inst->chunkFrames;
+        }
+        inst->scratchSpanL = inst->scratch + (size_t)KERNEL_SCRATCH_BUFFERS * inst->chunkFrames;
+        inst->scratchSpanR = inst->scratchSpanL + 2 * (size_t)inst->chunkFrames;
+    }
+    inst->osWorkOdd = inst->osWorkEven + HALFBAND_HISTORY + 1 + 2 * chunkFrames;
+    inst->osRate2 = inst->osWorkOdd + HALFBAND_HISTORY + 1 + 2 * chunkFrames;
+    inst->osRate4 = inst->osRate2 + 2 * chunkFrames;
+    inst->osGain = inst->osRate4 + 4 * chunkFrames;
+    halfband_init();
+    ToneTable_Init(&inst->toneTable, inst->sampleRate);
+    for (int ch = 0; ch < MAX_CHANNELS; ch++) {
+        OnePoleFilter_Init(&inst->toneFilter[ch]);
+        OnePoleFilter_Init(&inst->tapToneFilter[ch]);
+    }
+    set_tone_pole(inst, ToneTable_Lookup(&inst->toneTable, inst->param_tone));
+    for (int t = 0; t < MAX_TAPS; t++) {
+        DelayTap_Init(&inst->taps[t], t);
+    }
+    lfo_table_init();
+    sinc_table_init();
+    FlutterLFO_Init(&inst->flutter, inst->sampleRate);
+    DuckFollower_Init(&inst->duck, inst->sampleRate);
+
+    /* Initialize smoothed values */
+    SmoothedValue_Init(&inst->smoothedDelayTime, GetDelayTimeSeconds(inst->param_time));
+    SmoothedValue_Init(&inst->smoothedFeedback, GetFeedback(inst->param_feedback, inst->param_drive));
+    SmoothedValue_Init(&inst->smoothedDrive, GetDriveGain(inst->param_drive));
+    SmoothedValue_Init(&inst->smoothedMix, inst->param_mix);
+    SmoothedValue_Init(&inst->smoothedTone, inst->param_tone);
+    SmoothedValue_Init(&inst->smoothedStereoWidth, GetStereoWidth(inst->param_stereo_width));
+
+    ParamQueue_Init(&inst->paramQueue);
+    record_default_params(inst);
+    atomic_init(&inst->clockTempo, 0);
+    MappedIo_Init(&inst->mapped, g_host);
+    inst->initialized = 1;
+
+    if (worker_buffers && Worker_Start(&inst->worker, worker_buffers, block_frames, kernel_run_block, inst) != 0) {
+        plugin_log("Worker thread failed to start, processing inline");
+    }
+    plugin_log("Instance created");
+    return inst;
+}
+
+static void v2_destroy_instance(void *instance) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)instance;
+    if (!inst) return;
+
+    plugin_log("Destroying instance");
+
+    /* The worker touches instance state until it is joined */
+    Worker_Stop(&inst->worker);
+
+    /* Instance and scratch live in the arena, the delay buffer in its own */
+    DelayGrowth_Release(&inst->delayGrowth);
+    Arena_Release(&inst->arena);
+}
+
+/* ============================================================================
+ * PARAM EVENTS - Applying queued changes on the audio thread
+ * ============================================================================ */
+
+/* Clear the allpass interpolator history of every head */
+static void reset_interpolation_state(spacecho_instance_t *inst) {
+    memset(inst->allpassState, 0, sizeof(inst->allpassState));
+    memset(inst->fadeAllpassState, 0, sizeof(inst->fadeAllpassState));
+    for (int t = 0; t < MAX_TAPS; t++) {
+        memset(inst->taps[t].allpassState, 0, sizeof(inst->taps[t].allpassState));
+    }
+}
+
+static void set_interpolation(spacecho_instance_t *inst, int mode) {
+    inst->delayLine.interpolation = mode;
+    reset_interpolation_state(inst);
+}
+
+/* Main head delay (samples) at rest; jump mode keeps it on whole samples */
+static inline float main_rest_samples(const spacecho_instance_t *inst) {
+    float samples = inst->smoothedDelayTime.currentValue * inst->sampleRate;
+    return inst->timeMode == TIME_MODE_JUMP ? roundf(samples) : samples;
+}
+
+/* Audio thread, jump mode: move the main head to target and crossfade from
+ * the old position. Queued if a crossfade is still running. */
+static void start_time_jump(spacecho_instance_t *inst, float target) {
+    if (inst->grain.mode != PLAYBACK_FORWARD) {
+        /* Grains pick the new time up at their next start */
+        SmoothedValue_SetTarget(&inst->smoothedDelayTime, target, 0);
+        inst->fadePending = -1.0f;
+        return;
+    }
+    if (inst->fadeRemaining > 0) {
+        inst->fadePending = target;
+        return;
+    }
+    inst->fadePending = -1.0f;
+
+    SmoothedValue *sv = &inst->smoothedDelayTime;
+    float from = sv->stepsRemaining > 0 ? sv->currentValue * inst->sampleRate : main_rest_samples(inst);
+    SmoothedValue_SetTarget(sv, target, 0);
+    if (main_rest_samples(inst) == from) return;
+
+    /* The old head takes over the allpass history; the new one starts clean */
+    inst->fadeFromSamples = from;
+    inst->fadeRemaining = inst->fadeFrames;
+    memcpy(inst->fadeAllpassState, inst->allpassState, sizeof(inst->allpassState));
+    memset(inst->allpassState, 0, sizeof(inst->allpassState));
+}
+
+static void set_time_mode(spacecho_instance_t *inst, int mode) {
+    if (mode == inst->timeMode) return;
+    SmoothedValue *sv = &inst->smoothedDelayTime;
+    if (mode == TIME_MODE_JUMP) {
+        inst->timeMode = mode;
+        if (sv->stepsRemaining > 0) start_time_jump(inst, sv->targetValue);
+    } else {
+        /* Hold the whole-sample position jump mode was reading, then glide */
+        SmoothedValue_SetTarget(sv, main_rest_samples(inst) / inst->sampleRate, 0);
+        inst->timeMode = mode;
+        if (inst->fadePending >= 0.0f) {
+            SmoothedValue_SetTarget(sv, inst->fadePending, inst->rampSamples);
+            inst->fadePending = -1.0f;
+        }
+    }
+}
+
+/* Loop length for the main head's (target) delay, within the buffer */
+static int freeze_loop_length(const spacecho_instance_t *inst) {
+    int length = (int)lroundf(inst->smoothedDelayTime.targetValue * inst->sampleRate);
+    if (length < 1) length = 1;
+    if (length > inst->delayLine.bufferLength - 1) length = inst->delayLine.bufferLength - 1;
+    return length;
+}
+
+static void set_freeze(spacecho_instance_t *inst, int mode) {
+    if (mode == inst->frozen) return;
+    if (mode == FREEZE_ON) {
+        inst->frozen = 1;
+        inst->freezeLength = freeze_loop_length(inst);
+        inst->freezeCursor = 0;
+        return;
+    }
+    /* Crossfade from where the loop is playing to the main head, which now
+     * reads a delay of freezeLength behind writes that resume at the loop end */
+    inst->frozen = 0;
+    inst->fadeFromSamples = (float)(inst->freezeLength - inst->freezeCursor);
+    inst->fadeRemaining = inst->fadeFrames;
+    memset(inst->fadeAllpassState, 0, sizeof(inst->fadeAllpassState));
+}
+
+/* Play n loop frames into l/r; no crossfade runs while frozen */
+static void freeze_read(spacecho_instance_t *inst, float *l, float *r, int n) {
+    const StereoDelayLine *dl = &inst->delayLine;
+    inst->fadeRemaining = 0;
+    int done = 0;
+    while (done < n) {
+        int span = inst->freezeLength - inst->freezeCursor;
+        if (span > n - done) span = n - done;
+        uint32_t start = (uint32_t)(dl->writePosition - inst->freezeLength + inst->freezeCursor);
+        StereoDelayLine_CopyFrames(dl, start, l + done, r + done, span);
+        done += span;
+        inst->freezeCursor += span;
+        if (inst->freezeCursor >= inst->freezeLength) {
+            inst->freezeCursor = 0;
+            inst->freezeLength = freeze_loop_length(inst);
+        }
+    }
+}
+
+/* Grain length for the main head's (target) delay, within PLAYBACK_REACH of the buffer */
+static int playback_grain_length(const spacecho_instance_t *inst) {
+    int length = (int)lroundf(inst->smoothedDelayTime.targetValue * inst->sampleRate);
+    int longest = (int)((float)(inst->delayLine.bufferLength - 1 - inst->chunkFrames) / PLAYBACK_REACH);
+    if (length > longest) length = longest;
+    return length > 1 ? length : 1;
+}
+
+/* Crossfade a non-forward grain of 'length' frames can take at its end. A
+ * fading double-speed grain closes in on the write head, so it must stay a
+ * chunk clear of it. */
+static int playback_fade_limit(const spacecho_instance_t *inst, int fade, int length) {
+    if (fade > length / 4) fade = length / 4;
+    if (fade > length - inst->chunkFrames - 1) fade = length - inst->chunkFrames - 1;
+    return fade > 1 ? fade : 1;
+}
+
+/* Start a grain 'offset' frames into the current chunk; the one playing fades out */
+static void playback_start_grain(spacecho_instance_t *inst, int mode, int offset) {
+    int fade = inst->grainFadeFrames;
+    if (inst->grain.mode != PLAYBACK_FORWARD) fade = playback_fade_limit(inst, fade, inst->grainLength);
+    inst->grainOld = inst->grain;
+    inst->grainLength = playback_grain_length(inst);
+    if (mode != PLAYBACK_FORWARD) fade = playback_fade_limit(inst, fade, inst->grainLength);
+    PlaybackGrain_Start(&inst->grain, mode, (uint32_t)(inst->delayLine.writePosition + offset), inst->grainLength,
+                        inst->chunkFrames);
+    inst->grainFade = inst->grainFadeRemaining = fade;
+}
+
+static void set_playback(spacecho_instance_t *inst, int mode) {
+    if (mode == inst->grain.mode) return;
+    DelayGrowth_Want(&inst->delayGrowth, &inst->delayLine,
+                     delay_length_for(inst, inst->smoothedDelayTime.targetValue * PLAYBACK_REACH));
+    if (mode == PLAYBACK_FORWARD) {
+        /* The main head resumes after sitting idle */
+        memset(inst->allpassState, 0, sizeof(inst->allpassState));
+    }
+    playback_start_grain(inst, mode, 0);
+}
+
+/* Grains (or a crossfade out of them) replace the main head */
+static inline int playback_active(const spacecho_instance_t *inst) {
+    return inst->grain.mode != PLAYBACK_FORWARD || inst->grainFadeRemaining > 0;
+}
+
+/* The regular main head is still heard: forward, or fading in or out */
+static inline int playback_uses_head(const spacecho_instance_t *inst) {
+    return inst->grain.mode == PLAYBACK_FORWARD ||
+           (inst->grainFadeRemaining > 0 && inst->grainOld.mode == PLAYBACK_FORWARD);
+}
+
+/* Play n frames of grains into l/r, which hold the main head's output when
+ * playback_uses_head; NULL l/r only advance the grains */
+static void playback_read(spacecho_instance_t *inst, float *l, float *r, int n) {
+    const StereoDelayLine *dl = &inst->delayLine;
+    int done = 0;
+    while (done < n) {
+        int span = n - done;
+        if (inst->grain.mode != PLAYBACK_FORWARD) {
+            if (inst->grain.elapsed >= inst->grainLength) {
+                playback_start_grain(inst, inst->grain.mode, done);
+                continue;
+            }
+            if (span > inst->grainLength - inst->grain.elapsed) span = inst->grainLength - inst->grain.elapsed;
+        }
+        const int fading = inst->grainFadeRemaining > 0;
+        if (fading && span > inst->grainFadeRemaining) span = inst->grainFadeRemaining;
+
+        if (l) {
+            float *outL = l + done, *outR = r + done;
+            float *oldL = inst->scratchGrainL, *oldR = inst->scratchGrainR;
+            if (fading && inst->grainOld.mode == PLAYBACK_FORWARD) {
+                memcpy(oldL, outL, (size_t)span * sizeof(float));
+                memcpy(oldR, outR, (size_t)span * sizeof(float));
+            } else if (fading) {
+                PlaybackGrain_Read(dl, &inst->grainOld, inst->scratchSpanL, inst->scratchSpanR, oldL, oldR, span);
+            }
+            if (inst->grain.mode != PLAYBACK_FORWARD) {
+                PlaybackGrain_Read(dl, &inst->grain, inst->scratchSpanL, inst->scratchSpanR, outL, outR, span);
+            }
+            if (fading) {
+                const float inv = 1.0f / (float)inst->grainFade;
+                const int at = inst->grainFade - inst->grainFadeRemaining;
+                for (int i = 0; i < span; i++) {
+                    float p = (float)(at + i + 1) * inv;
+                    outL[i] = outL[i] * sqrtf(p) + oldL[i] * sqrtf(1.0f - p);
+                    outR[i] = outR[i] * sqrtf(p) + oldR[i] * sqrtf(1.0f - p);
+                }
+            }
+        }
+        if (fading) {
+            inst->grainFadeRemaining -= span;
+            inst->grainOld.elapsed += span;
+        }
+        inst->grain.elapsed += span;
+        done += span;
+    }
+}
+
+static void apply_param_event(spacecho_instance_t *inst, const ParamEvent *ev);
+
+/* Audio thread: retarget a synced head (tap < 0: the main head) from syncBpm */
+static void retime_synced(spacecho_instance_t *inst, int tap) {
+    ParamEvent ev = {0};
+    float ms = compute_synced_time(inst->syncBpm, tap < 0 ? inst->syncDivision : inst->taps[tap].syncDivision);
+    if (ms <= 0.0f) return;
+    ev.type = tap < 0 ? PARAM_EVENT_DELAY_TIME : PARAM_EVENT_TAP_TIME;
+    ev.tap = (uint8_t)(tap < 0 ? 0 : tap);
+    ev.a = ms * 0.001f;  /* unrounded, so tempo changes glide */
+    apply_param_event(inst, &ev);
+}
+
+/* Audio thread: retarget smoothing / DSP state for one event */
+static void apply_param_event(spacecho_instance_t *inst, const ParamEvent *ev) {
+    switch (ev->type) {
+    case PARAM_EVENT_DELAY_TIME:
+        DelayGrowth_Want(&inst->delayGrowth, &inst->delayLine,
+                         delay_length_for(inst, inst->grain.mode != PLAYBACK_FORWARD ? ev->a * PLAYBACK_REACH : ev->a));
+        if (inst->timeMode == TIME_MODE_JUMP) start_time_jump(inst, ev->a);
+        else SmoothedValue_SetTarget(&inst->smoothedDelayTime, ev->a, inst->rampSamples);
+        break;
+    case PARAM_EVENT_FEEDBACK:
+        SmoothedValue_SetTarget(&inst->smoothedFeedback, ev->a, inst->rampSamples);
+        break;
+    case PARAM_EVENT_DRIVE:
+        SmoothedValue_SetTarget(&inst->smoothedDrive, ev->a, inst->rampSamples);
+        break;
+    case PARAM_EVENT_OVERSAMPLING:
+        if ((int)ev->a != inst->oversampling) {
+            inst->oversampling = (int)ev->a;
+            memset(inst->halfband, 0, sizeof(inst->halfband));
+        }
+        break;
+    case PARAM_EVENT_MIX:
+        SmoothedValue_SetTarget(&inst->smoothedMix, ev->a, inst->rampSamples);
+        break;
+    case PARAM_EVENT_TONE:
+        SmoothedValue_SetTarget(&inst->smoothedTone, ev->a, inst->rampSamples);
+        break;
+    case PARAM_EVENT_WIDTH:
+        SmoothedValue_SetTarget(&inst->smoothedStereoWidth, ev->a, inst->rampSamples);
+        break;
+    case PARAM_EVENT_MODULATION:
+        FlutterLFO_SetDepth(&inst->flutter, ev->a, ev->b);
+        break;
+    case PARAM_EVENT_QUALITY:
+        set_interpolation(inst, (int)ev->a);
+        break;
+    case PARAM_EVENT_TIME_MODE:
+        set_time_mode(inst, (int)ev->a);
+        break;
+    case PARAM_EVENT_TAPS:
+        inst->activeTaps = (int)ev->a;
+        break;
+    case PARAM_EVENT_FREEZE:
+        set_freeze(inst, (int)ev->a);
+        break;
+    case PARAM_EVENT_PLAYBACK:
+        set_playback(inst, (int)ev->a);
+        break;
+    case PARAM_EVENT_DUCKING:
+        inst->duck.depth = ev->a;
+        if (ev->a == 0.0f) DuckFollower_Reset(&inst->duck);
+        break;
+    case PARAM_EVENT_TAP_TIME:
+        DelayGrowth_Want(&inst->delayGrowth, &inst->delayLine, delay_length_for(inst, ev->a));
+        SmoothedValue_SetTarget(&inst->taps[ev->tap].smoothedTime, ev->a, inst->rampSamples);
+        break;
+    case PARAM_EVENT_TAP_GAINS:
+        SmoothedValue_SetTarget(&inst->taps[ev->tap].smoothedGainL, ev->a, inst->rampSamples);
+        SmoothedValue_SetTarget(&inst->taps[ev->tap].smoothedGainR, ev->b, inst->rampSamples);
+        break;
+    case PARAM_EVENT_DIVISION:
+        if ((int)ev->a != inst->syncDivision) {
+            inst->syncDivision = (int)ev->a;
+            retime_synced(inst, -1);
+        }
+        break;
+    case PARAM_EVENT_TAP_DIVISION:
+        if ((int)ev->a != inst->taps[ev->tap].syncDivision) {
+            inst->taps[ev->tap].syncDivision = (int)ev->a;
+            retime_synced(inst, ev->tap);
+        }
+        break;
+    case PARAM_EVENT_BPM:
+        inst->syncBpm = ev->a;
+        for (int t = -1; t < MAX_TAPS; t++) retime_synced(inst, t);
+        break;
+    }
+#ifdef SPACECHO_PERF_STATS
+    /* Every event but the mode switches, ducking and the sync changes (which
+     * count through the time events they apply) starts a ramp or a crossfade */
+    if (ev->type != PARAM_EVENT_MODULATION && ev->type != PARAM_EVENT_QUALITY &&
+        ev->type != PARAM_EVENT_TIME_MODE && ev->type != PARAM_EVENT_OVERSAMPLING &&
+        ev->type != PARAM_EVENT_TAPS && ev->type != PARAM_EVENT_FREEZE &&
+        ev->type != PARAM_EVENT_PLAYBACK && ev->type != PARAM_EVENT_DUCKING &&
+        ev->type != PARAM_EVENT_DIVISION && ev->type != PARAM_EVENT_TAP_DIVISION &&
+        ev->type != PARAM_EVENT_BPM) {
+        PerfStats_Count(&inst->perf.ramps, 1);
+    }
+#endif
+}
+
+/* Audio thread: replay the latest event of every type and tap after an
+ * overflow. The divisions and tempo go last, so the synced heads retime over
+ * any older time. */
+static void resync_params(spacecho_instance_t *inst) {
+    static const uint8_t globals[] = {
+        PARAM_EVENT_TIME_MODE, PARAM_EVENT_DELAY_TIME, PARAM_EVENT_FEEDBACK, PARAM_EVENT_DRIVE,
+        PARAM_EVENT_OVERSAMPLING, PARAM_EVENT_MIX, PARAM_EVENT_TONE, PARAM_EVENT_WIDTH,
+        PARAM_EVENT_MODULATION, PARAM_EVENT_QUALITY, PARAM_EVENT_TAPS, PARAM_EVENT_FREEZE,
+        PARAM_EVENT_PLAYBACK, PARAM_EVENT_DUCKING,
+    };
+    static const uint8_t perTap[] = { PARAM_EVENT_TAP_TIME, PARAM_EVENT_TAP_GAINS, PARAM_EVENT_TAP_DIVISION };
+    ParamEvent ev;
+    for (size_t k = 0; k < sizeof(globals); k++) {
+        ParamQueue_Latest(&inst->paramQueue, globals[k], 0, &ev);
+        apply_param_event(inst, &ev);
+    }
+    for (int t = 0; t < MAX_TAPS; t++) {
+        for (size_t k = 0; k < sizeof(perTap); k++) {
+            ParamQueue_Latest(&inst->paramQueue, perTap[k], t, &ev);
+            apply_param_event(inst, &ev);
+        }
+    }
+    ParamQueue_Latest(&inst->paramQueue, PARAM_EVENT_DIVISION, 0, &ev);
+    apply_param_event(inst, &ev);
+    ParamQueue_Latest(&inst->paramQueue, PARAM_EVENT_BPM, 0, &ev);
+    apply_param_event(inst, &ev);
+    /* A tempo the clock has sent outranks the queued one; drain re-applies it */
+    inst->syncSeen = 0;
+}
+
+/* Audio thread (or the worker), start of each block */
+static void drain_param_queue(spacecho_instance_t *inst) {
+    /* A longer buffer goes in before the time change that asked for it */
+    int oldLength = DelayGrowth_Take(&inst->delayGrowth, &inst->delayLine);
+    if (oldLength && inst->tailSilentFrames >= oldLength) {
+        inst->tailSilentFrames = inst->delayLine.bufferLength;  /* the new part is zeroed */
+    }
+    ParamEvent ev;
+    while (ParamQueue_Pop(&inst->paramQueue, &ev)) {
+        apply_param_event(inst, &ev);
+    }
+    if (ParamQueue_TakeResync(&inst->paramQueue)) {
+        resync_params(inst);
+    }
+    /* The clock tempo goes in after the queued changes, so an older time
+     * posted by set_param never overrides it */
+    uint64_t tempo = atomic_load_explicit(&inst->clockTempo, memory_order_acquire);
+    if ((uint32_t)(tempo >> 32) != inst->syncSeen) {
+        inst->syncSeen = (uint32_t)(tempo >> 32);
+        ev.type = PARAM_EVENT_BPM;
+        ev.a = clock_tempo_bpm(tempo);
+        apply_param_event(inst, &ev);
+    }
+}
+
+/* set_param thread: hand one change to the audio thread */
+static void post_param_event(spacecho_instance_t *inst, const ParamEvent *ev) {
+    if (ev->type == PARAM_EVENT_DELAY_TIME || ev->type == PARAM_EVENT_TAP_TIME) {
+        float reach = ev->a;
+        if (ev->type == PARAM_EVENT_DELAY_TIME && inst->param_playback != PLAYBACK_FORWARD) reach *= PLAYBACK_REACH;
+        DelayGrowth_Reserve(&inst->delayGrowth, delay_length_for(inst, reach));
+    } else if (ev->type == PARAM_EVENT_PLAYBACK && ev->a != (float)PLAYBACK_FORWARD) {
+        DelayGrowth_Reserve(&inst->delayGrowth,
+                            delay_length_for(inst, GetDelayTimeSeconds(inst->param_time) * PLAYBACK_REACH));
+    }
+    ParamQueue_Push(&inst->paramQueue, ev);
+}
+
+static void post_param(spacecho_instance_t *inst, int type, int tap, float a, float b) {
+    ParamEvent ev;
+    ev.type = (uint8_t)type;
+    ev.tap = (uint8_t)tap;
+    ev.a = a;
+    ev.b = b;
+    post_param_event(inst, &ev);
+}
+
+/*
+ * Feedback saturation at 2x/4x for one channel, in place. Runs whenever
+ * oversampling is on (even with drive off) so the loop latency stays fixed.
+ * gains: per-base-frame drive gain plane, or NULL for a constant gain.
+ */
+static void saturate_oversampled(spacecho_instance_t *inst, int ch, float *x, const float *gains, float gain, int n) {
+    HalfBandState *st = inst->halfband[ch];
+    const int factor = inst->oversampling == OVERSAMPLING_4X ? 4 : 2;
+    float *rate = factor == 4 ? inst->osRate4 : inst->osRate2;
+
+    HalfBand_Up(&g_halfband[0], st[0].up, x, inst->osRate2, inst->osWorkEven, n);
+    if (factor == 4) HalfBand_Up(&g_halfband[1], st[1].up, inst->osRate2, inst->osRate4, inst->osWorkEven, 2 * n);
+    if (gains) {
+        for (int i = 0; i < factor * n; i++) inst->osGain[i] = gains[i / factor];
+        SoftClip_Block(rate, inst->osGain, gain, factor * n);
+    } else if (gain != 1.0f) {
+        SoftClip_Block(rate, NULL, gain, factor * n);
+    }
+    if (factor == 4) {
+        HalfBand_Down(&g_halfband[1], st[1].downEven, st[1].downOdd, inst->osRate4, inst->osRate2,
+                      inst->osWorkEven, inst->osWorkOdd, 2 * n);
+    }
+    HalfBand_Down(&g_halfband[0], st[0].downEven, st[0].downOdd, inst->osRate2, x,
+                  inst->osWorkEven, inst->osWorkOdd, n);
+}
+
+/*
+ * Reference per-frame implementation. Kept for verification of the block
+ * kernel; build with -DSPACECHO_REFERENCE_KERNEL to run it in place of it.
+ */
+__attribute__((unused))
+static void v2_process_block_reference(void *instance, int16_t *audio_inout, int frames) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)instance;
+    if (!inst || !inst->initialized) return;
+    const int16_t *in;
+    int16_t *out;
+    if (!MappedIo_Resolve(&inst->mapped, audio_inout, frames, &in, &out)) return;
+    kernel_pass_through(in, out, frames);  /* the reference works in place */
+    audio_inout = out;
+    uint64_t fpMode = ftz_enter();
+    drain_param_queue(inst);
+    if (inst->fadeRemaining == 0 && inst->fadePending >= 0.0f) {
+        start_time_jump(inst, inst->fadePending);
+    }
+
+    /* Time base for MIDI clock tick stamps */
+    inst->clock_sample_pos += frames;
+
+    for (int i = 0; i < frames; i++) {
+        /* Get smoothed parameter values */
+        float delayTime = SmoothedValue_GetNext(&inst->smoothedDelayTime);
+        if (inst->timeMode == TIME_MODE_JUMP) delayTime = main_rest_samples(inst) / inst->sampleRate;
+        float feedback = SmoothedValue_GetNext(&inst->smoothedFeedback);
+        float drive = SmoothedValue_GetNext(&inst->smoothedDrive);
+        float mix = SmoothedValue_GetNext(&inst->smoothedMix);
+        float stereoWidth = SmoothedValue_GetNext(&inst->smoothedStereoWidth);
+        float modulation = FlutterLFO_IsActive(&inst->flutter) ? FlutterLFO_Next(&inst->flutter) : 0.0f;
+        delayTime += modulation;
+        if (inst->smoothedTone.stepsRemaining > 0) {
+            set_tone_pole(inst, ToneTable_Lookup(&inst->toneTable, SmoothedValue_GetNext(&inst->smoothedTone)));
+        }
+
+        /* Convert input to float */
+        float inL = audio_inout[i * 2] / 32768.0f;
+        float inR = audio_inout[i * 2 + 1] / 32768.0f;
+
+        /* Read both channels from the delay line */
+        float delayedL = 0.0f, delayedR = 0.0f;
+        int tapWritePos = inst->delayLine.writePosition;
+        if (inst->frozen) {
+            freeze_read(inst, &delayedL, &delayedR, 1);
+        } else {
+            if (playback_uses_head(inst)) {
+                StereoDelayLine_Read(&inst->delayLine, delayTime, inst->allpassState, &delayedL, &delayedR);
+            }
+            if (playback_active(inst)) playback_read(inst, &delayedL, &delayedR, 1);
+        }
+
+        /* Jump crossfade: equal-power blend from the old head */
+        if (inst->fadeRemaining > 0) {
+            float p = (float)(inst->fadeFrames - inst->fadeRemaining + 1) * (1.0f / (float)inst->fadeFrames);
+            float oldL, oldR;
+            StereoDelayLine_Read(&inst->delayLine, inst->fadeFromSamples / inst->sampleRate + modulation,
+                                 inst->fadeAllpassState, &oldL, &oldR);
+            delayedL = delayedL * sqrtf(p) + oldL * sqrtf(1.0f - p);
+            delayedR = delayedR * sqrtf(p) + oldR * sqrtf(1.0f - p);
+            inst->fadeRemaining--;
+        }
+
+        /* Apply tone filter to delayed signal */
+        delayedL = OnePoleFilter_Process(&inst->toneFilter[0], delayedL);
+        delayedR = OnePoleFilter_Process(&inst->toneFilter[1], delayedR);
+
+        /*
+         * Width-dependent ping-pong input routing:
+         * - width=0.0: original crossfeed behavior (preserves previous mono-width level)
+         * - width=1.0: mono-seeded ping-pong (centered mono input still alternates L/R)
+         */
+        if (!inst->frozen) {  /* frozen: the loop is held, nothing is written */
+            float monoInput = 0.5f * (inL + inR);
+            float pingInputL = inR * (1.0f - stereoWidth);
+            float pingInputR = inL * (1.0f - stereoWidth) + monoInput * stereoWidth;
+            float writeL = pingInputL + delayedR * feedback;
+            float writeR = pingInputR + delayedL * feedback;
+            if (inst->oversampling != OVERSAMPLING_OFF) {
+                saturate_oversampled(inst, 0, &writeL, NULL, drive, 1);
+                saturate_oversampled(inst, 1, &writeR, NULL, drive, 1);
+            } else if (drive != 1.0f) {
+                writeL = SoftClip(writeL, drive);
+                writeR = SoftClip(writeR, drive);
+            }
+#ifdef DENORMAL_DC
+            writeL += DENORMAL_DC;
+            writeR += DENORMAL_DC;
+#endif
+            StereoDelayLine_Write(&inst->delayLine, writeL, writeR);
+        }
+
+        /* Stereo width on wet path: 0 = mono, 1 = full L/R */
+        float wetMono = 0.5f * (delayedL + delayedR);
+        float wetL = wetMono + (delayedL - wetMono) * stereoWidth;
+        float wetR = wetMono + (delayedR - wetMono) * stereoWidth;
+
+        /* Keep perceived wet level more stable while widening. */
+        float widthLevelComp = 1.0f / sqrtf(1.0f - 0.5f * stereoWidth);
+        if (widthLevelComp > 1.333333f) widthLevelComp = 1.333333f;
+        wetL *= widthLevelComp;
+        wetR *= widthLevelComp;
+
+        /* Multi-tap heads, read before this frame's write, panned after width */
+        if (inst->activeTaps > 0 && inst->frozen) {
+            for (int t = 0; t < inst->activeTaps; t++) {
+                SmoothedValue_GetNext(&inst->taps[t].smoothedTime);
+                SmoothedValue_GetNext(&inst->taps[t].smoothedGainL);
+                SmoothedValue_GetNext(&inst->taps[t].smoothedGainR);
+            }
+        } else if (inst->activeTaps > 0) {
+            float tapL = 0.0f, tapR = 0.0f;
+            for (int t = 0; t < inst->activeTaps; t++) {
+                DelayTap *tap = &inst->taps[t];
+                float l, r;
+                StereoDelayLine_ReadFrom(&inst->delayLine, tapWritePos,
+                                         SmoothedValue_GetNext(&tap->smoothedTime) + modulation,
+                                         tap->allpassState, &l, &r);
+                float mono = 0.5f * (l + r);
+                tapL += mono * SmoothedValue_GetNext(&tap->smoothedGainL);
+                tapR += mono * SmoothedValue_GetNext(&tap->smoothedGainR);
+            }
+            wetL += OnePoleFilter_Process(&inst->tapToneFilter[0], tapL);
+            wetR += OnePoleFilter_Process(&inst->tapToneFilter[1], tapR);
+        }
+
+        /* Ducking under the dry input */
+        if (inst->duck.depth > 0.0f) {
+            float gain;
+            DuckFollower_Fill(&inst->duck, &inL, &inR, &gain, 1);
+            wetL *= gain;
+            wetR *= gain;
+        }
+
+        /* Mix dry/wet */
+        float outL = inL * (1.0f - mix) + wetL * mix;
+        float outR = inR * (1.0f - mix) + wetR * mix;
+
+        /* Soft clip output */
+        if (outL > 1.0f) outL = 1.0f;
+        if (outL < -1.0f) outL = -1.0f;
+        if (outR > 1.0f) outR = 1.0f;
+        if (outR < -1.0f) outR = -1.0f;
+
+        /* Convert back to int16 */
+        audio_inout[i * 2] = (int16_t)(outL * 32767.0f);
+        audio_inout[i * 2 + 1] = (int16_t)(outR * 32767.0f);
+    }
+    ftz_leave(fpMode);
+}
+
+
+/* ============================================================================
+ * BLOCK KERNEL - Planar float scratch processed in short vectors
+ *
+ * The interleaved int16 block is decoded into planar scratch, each stage runs
+ * over a whole chunk, and the result is narrowed back with saturation. A chunk
+ * is fully read before it is written, which matches the per-frame loop as long
+ * as chunkFrames stays below the shortest delay (20ms = 882 samples at 44.1kHz).
+ *
+ * Smoothed parameters are resolved once per chunk into a KernelControl. In
+ * the steady state nothing is filled per frame and the stages run on hoisted
+ * constants; while a ramp is active they read the per-frame planes, and the
+ * width level compensation is evaluated every CONTROL_RATE_FRAMES frames and
+ * interpolated in between.
+ * ============================================================================ */
+
+#define CONTROL_RATE_FRAMES 16
+
+/* dst += src */
+static void kernel_accumulate(float *dst, const float *src, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] += src[i];
+    }
+}
+
 typedef struct {
-    char module_dir[256];
+    const float *delay;    /* per-frame main head delay (seconds), NULL when settled */
+    const float *mod;      /* per-frame flutter/wow offset (seconds), NULL when off */
+    const float *tone;     /* per-frame tone filter pole, NULL when settled */
+    uint32_t delayPhase;   /* fixed-point delay when settled and unmodulated */
+    const float *fadeIn;   /* per-frame new / old head gains while crossfading, NULL otherwise */
+    const float *fadeOut;
+    const float *fadeDelay; /* old head delay (seconds) when modulated */
+    uint32_t fadePhase;    /* old head fixed-point delay when unmodulated */
+    int ramping;           /* feedback, mix or width moving: stages read the planes */
+    const float *drive;    /* per-frame saturation gain while drive ramps, NULL when settled */
+    float driveGain;       /* settled saturation gain (1 = stage off) */
+    int wetMuted;          /* mix settled at 0: only the delay line is fed */
+    float feedback;        /* settled values, valid when !ramping */
+    float mix;
+    float width;
+    float widthComp;
+} KernelControl;
 
-    /* Delay lines and filters */
-    DelayLine delayLine[MAX_CHANNELS];
-    OnePoleFilter toneFilter[MAX_CHANNELS];
+/* Resolve this chunk's smoothed values: constants when settled, planes otherwise */
+static void kernel_control(spacecho_instance_t *inst, KernelControl *ctl, int n) {
+    const StereoDelayLine *dl = &inst->delayLine;
+    int modulated = FlutterLFO_IsActive(&inst->flutter);
+    if (inst->fadeRemaining == 0 && inst->fadePending >= 0.0f) {
+        start_time_jump(inst, inst->fadePending);
+    }
 
-    /* Smoothed values */
-    SmoothedValue smoothedDelayTime;
-    SmoothedValue smoothedFeedback;
-    SmoothedValue smoothedMix;
-    SmoothedValue smoothedTone;
-    SmoothedValue smoothedStereoWidth;
+    if (inst->smoothedDelayTime.stepsRemaining > 0 || modulated) {
+        if (inst->timeMode == TIME_MODE_JUMP) {
+            const float rest = main_rest_samples(inst) / dl->sampleRate;
+            for (int i = 0; i < n; i++) inst->scratchDelay[i] = rest;
+        } else {
+            SmoothedValue_Fill(&inst->smoothedDelayTime, inst->scratchDelay, n);
+        }
+        if (modulated) {
+            /* Flutter/wow: one offset per frame, shared by every read head */
+            FlutterLFO_Fill(&inst->flutter, inst->scratchMod, n);
+            kernel_accumulate(inst->scratchDelay, inst->scratchMod, n);
+        }
+        ctl->delay = inst->scratchDelay;
+        ctl->delayPhase = 0;
+        ctl->mod = modulated ? inst->scratchMod : NULL;
+    } else {
+        ctl->mod = NULL;
+        ctl->delay = NULL;
+        ctl->delayPhase = StereoDelayLine_DelayToPhase(dl, main_rest_samples(inst));
+    }
 
-    /* Parameters */
-    int param_time;        /* milliseconds (20-2000) */
-    float param_feedback;
-    float param_mix;
-    float param_tone;
-    int param_stereo_width; /* percent (0=mono, 100=full L/R) */
-    int param_division;    /* DIV_FREE..DIV_16T */
-    int param_bpm;         /* detected BPM from MIDI clock (40-300) */
+    /* Jump crossfade: gains for this chunk and the old head's delay */
+    ctl->fadeIn = ctl->fadeOut = ctl->fadeDelay = NULL;
+    ctl->fadePhase = 0;
+    if (inst->fadeRemaining > 0) {
+        float *gIn = inst->scratchFadeIn, *gOut = inst->scratchFadeOut;
+        const float inv = 1.0f / (float)inst->fadeFrames;
+        const int done = inst->fadeFrames - inst->fadeRemaining;
+        for (int i = 0; i < n; i++) {
+            float p = (float)(done + i + 1) * inv;
+            if (p > 1.0f) p = 1.0f;
+            gIn[i] = sqrtf(p);
+            gOut[i] = sqrtf(1.0f - p);
+        }
+        inst->fadeRemaining = inst->fadeRemaining > n ? inst->fadeRemaining - n : 0;
+        if (modulated) {
+            const float from = inst->fadeFromSamples / dl->sampleRate;
+            for (int i = 0; i < n; i++) inst->scratchFadeDelay[i] = from + inst->scratchMod[i];
+            ctl->fadeDelay = inst->scratchFadeDelay;
+        } else {
+            ctl->fadePhase = StereoDelayLine_DelayToPhase(dl, inst->fadeFromSamples);
+        }
+        ctl->fadeIn = gIn;
+        ctl->fadeOut = gOut;
+    }
 
-    /* MIDI clock detection */
-    int clock_sample_counter;  /* samples accumulated over current quarter note */
-    int clock_tick_count;      /* counts 0xF8 ticks within current quarter note */
-    int clock_running;         /* received enough ticks to derive BPM */
+    /* Tone ramps per frame through the table; the filters keep the last pole */
+    ctl->tone = NULL;
+    if (inst->smoothedTone.stepsRemaining > 0) {
+        float *pole = inst->scratchTone;
+        SmoothedValue_Fill(&inst->smoothedTone, pole, n);
+        for (int i = 0; i < n; i++) {
+            pole[i] = ToneTable_Lookup(&inst->toneTable, pole[i]);
+        }
+        set_tone_pole(inst, pole[n - 1]);
+        ctl->tone = pole;
+    }
 
-    int initialized;
-} spacecho_instance_t;
+    ctl->ramping = inst->smoothedFeedback.stepsRemaining > 0 || inst->smoothedMix.stepsRemaining > 0 ||
+                   inst->smoothedStereoWidth.stepsRemaining > 0;
+    if (ctl->ramping) {
+        SmoothedValue_Fill(&inst->smoothedFeedback, inst->scratchFeedback, n);
+        SmoothedValue_Fill(&inst->smoothedMix, inst->scratchMix, n);
+        SmoothedValue_Fill(&inst->smoothedStereoWidth, inst->scratchWidth, n);
+    }
+    ctl->drive = NULL;
+    if (inst->smoothedDrive.stepsRemaining > 0) {
+        SmoothedValue_Fill(&inst->smoothedDrive, inst->scratchDrive, n);
+        ctl->drive = inst->scratchDrive;
+    }
+    ctl->driveGain = inst->smoothedDrive.currentValue;
+    ctl->feedback = inst->smoothedFeedback.currentValue;
+    ctl->mix = inst->smoothedMix.currentValue;
+    ctl->width = inst->smoothedStereoWidth.currentValue;
+    ctl->widthComp = GetWidthLevelComp(ctl->width);
+}
 
-static void* v2_create_instance(const char *module_dir, const char *config_json) {
-    plugin_log("Creating instance");
-    (void)config_json;
+static void kernel_decode(const int16_t *in, float *l, float *r, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    const float scale = 1.0f / 32768.0f;
+    for (; i + 8 <= n; i += 8) {
+        int16x8x2_t v = vld2q_s16(in + i * 2);
+        vst1q_f32(l + i,     vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v.val[0]))), scale));
+        vst1q_f32(l + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v.val[0]))), scale));
+        vst1q_f32(r + i,     vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v.val[1]))), scale));
+        vst1q_f32(r + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v.val[1]))), scale));
+    }
+#endif
+    for (; i < n; i++) {
+        l[i] = in[i * 2] / 32768.0f;
+        r[i] = in[i * 2 + 1] / 32768.0f;
+    }
+}
 
-    spacecho_instance_t *inst = (spacecho_instance_t*)calloc(1, sizeof(spacecho_instance_t));
-    if (!inst) {
-        plugin_log("Failed to allocate instance");
-        return NULL;
+#ifdef SPACECHO_HAVE_NEON
+static inline int16x4_t kernel_narrow4(const float *src) {
+    float32x4_t x = vld1q_f32(src);
+    x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f));
+    return vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(x, 32767.0f)));
+}
+#endif
+
+static void kernel_encode(const float *l, const float *r, int16_t *out, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 8 <= n; i += 8) {
+        int16x8x2_t v;
+        v.val[0] = vcombine_s16(kernel_narrow4(l + i), kernel_narrow4(l + i + 4));
+        v.val[1] = vcombine_s16(kernel_narrow4(r + i), kernel_narrow4(r + i + 4));
+        vst2q_s16(out + i * 2, v);
+    }
+#endif
+    for (; i < n; i++) {
+        float outL = l[i];
+        float outR = r[i];
+        if (outL > 1.0f) outL = 1.0f;
+        if (outL < -1.0f) outL = -1.0f;
+        if (outR > 1.0f) outR = 1.0f;
+        if (outR < -1.0f) outR = -1.0f;
+        out[i * 2] = (int16_t)(outL * 32767.0f);
+        out[i * 2 + 1] = (int16_t)(outR * 32767.0f);
+    }
+}
+
+#ifndef SPACECHO_REFERENCE_KERNEL
+/* Float I/O (process_block_f32): frame i of each channel at [i * stride]; no
+ * scaling, and no clamping on the way out */
+static void kernel_load_f32(const float *inL, const float *inR, int stride, float *l, float *r, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    if (stride == 2 && inR == inL + 1) {
+        for (; i + 4 <= n; i += 4) {
+            float32x4x2_t v = vld2q_f32(inL + i * 2);
+            vst1q_f32(l + i, v.val[0]);
+            vst1q_f32(r + i, v.val[1]);
+        }
+    } else if (stride == 1) {
+        for (; i + 4 <= n; i += 4) {
+            vst1q_f32(l + i, vld1q_f32(inL + i));
+            vst1q_f32(r + i, vld1q_f32(inR + i));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        l[i] = inL[i * stride];
+        r[i] = inR[i * stride];
+    }
+}
+
+static void kernel_store_f32(const float *l, const float *r, float *outL, float *outR, int stride, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    if (stride == 2 && outR == outL + 1) {
+        for (; i + 4 <= n; i += 4) {
+            float32x4x2_t v;
+            v.val[0] = vld1q_f32(l + i);
+            v.val[1] = vld1q_f32(r + i);
+            vst2q_f32(outL + i * 2, v);
+        }
+    } else if (stride == 1) {
+        for (; i + 4 <= n; i += 4) {
+            vst1q_f32(outL + i, vld1q_f32(l + i));
+            vst1q_f32(outR + i, vld1q_f32(r + i));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        outL[i * stride] = l[i];
+        outR[i * stride] = r[i];
+    }
+}
+#endif
+
+/* Read one head into planar l/r from a per-frame delay plane (seconds) or a
+ * settled fixed-point delay. A settled whole-sample delay with an interpolator
+ * that is exact at fraction 0 (linear, Hermite) is a plain deinterleaving copy.
+ * A chunk is read before it is written, so the write phase is advanced locally. */
+static void kernel_read_head(const StereoDelayLine *dl, const float *delay, uint32_t delayPhase,
+                             float *state, float *l, float *r, int n) {
+    const uint32_t phaseStep = 1u << dl->fracBits;
+    uint32_t writePhase = StereoDelayLine_WritePhase(dl, 0);
+    if (!delay && (delayPhase & dl->fracMask) == 0 &&
+        (dl->interpolation == INTERP_LINEAR || dl->interpolation == INTERP_HERMITE)) {
+        StereoDelayLine_CopyFrames(dl, (writePhase - delayPhase) >> dl->fracBits, l, r, n);
+        return;
+    }
+
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    const uint32_t laneOffsets[4] = { 0, phaseStep, phaseStep * 2, phaseStep * 3 };
+    const uint32x4_t laneStep = vld1q_u32(laneOffsets);
+    const int32x4_t indexShift = vdupq_n_s32(-dl->fracBits);
+    const uint32x4_t fracMask = vdupq_n_u32(dl->fracMask);
+    const float32x4_t minDelay = vdupq_n_f32(1.0f);
+    const float32x4_t maxDelay = vdupq_n_f32((float)(dl->bufferLength - 1));
+    const uint32x4_t settledDelay = vdupq_n_u32(delayPhase);
+    for (; i + 4 <= n; i += 4) {
+        /* Four phases at once: clamp, convert to fixed point, subtract from write phase */
+        uint32x4_t dq = settledDelay;
+        if (delay) {
+            float32x4_t ds = vmulq_n_f32(vld1q_f32(delay + i), dl->sampleRate);
+            ds = vminq_f32(vmaxq_f32(ds, minDelay), maxDelay);
+            dq = vcvtq_u32_f32(vmulq_n_f32(ds, dl->phaseScale));
+        }
+        uint32x4_t phase = vsubq_u32(vaddq_u32(vdupq_n_u32(writePhase), laneStep), dq);
+        uint32_t index[4];
+        float fraction[4];
+        vst1q_u32(index, vshlq_u32(phase, indexShift));
+        vst1q_f32(fraction, vmulq_n_f32(vcvtq_f32_u32(vandq_u32(phase, fracMask)), dl->fracScale));
+        writePhase += phaseStep * 4;
+
+        for (int k = 0; k < 4; k++) {
+            float32x2_t d = StereoDelayLine_InterpolateNeon(dl, index[k], fraction[k], state);
+            l[i + k] = vget_lane_f32(d, 0);
+            r[i + k] = vget_lane_f32(d, 1);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        uint32_t dq = delay ? StereoDelayLine_DelayToPhase(dl, delay[i] * dl->sampleRate) : delayPhase;
+        StereoDelayLine_ReadPhase(dl, writePhase - dq, state, &l[i], &r[i]);
+        writePhase += phaseStep;
+    }
+}
+
+/* dst = dst * gIn + src * gOut */
+static void kernel_crossfade(float *dst, const float *src, const float *gIn, const float *gOut, int n) {
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vmulq_f32(vld1q_f32(dst + i), vld1q_f32(gIn + i));
+        vst1q_f32(dst + i, vmlaq_f32(v, vld1q_f32(src + i), vld1q_f32(gOut + i)));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = dst[i] * gIn[i] + src[i] * gOut[i];
+    }
+}
+
+/* Main head (or grain) read into the wet planes, crossfaded with the old head after a jump */
+static void kernel_read(spacecho_instance_t *inst, const KernelControl *ctl, int n) {
+    const StereoDelayLine *dl = &inst->delayLine;
+    float *wetL = inst->scratchWetL;
+    float *wetR = inst->scratchWetR;
+    if (inst->frozen) {
+        freeze_read(inst, wetL, wetR, n);
+        return;
+    }
+
+    if (playback_uses_head(inst)) kernel_read_head(dl, ctl->delay, ctl->delayPhase, inst->allpassState, wetL, wetR, n);
+    if (playback_active(inst)) playback_read(inst, wetL, wetR, n);
+    if (ctl->fadeIn) {
+        kernel_read_head(dl, ctl->fadeDelay, ctl->fadePhase, inst->fadeAllpassState,
+                         inst->scratchFadeL, inst->scratchFadeR, n);
+        kernel_crossfade(wetL, inst->scratchFadeL, ctl->fadeIn, ctl->fadeOut, n);
+        kernel_crossfade(wetR, inst->scratchFadeR, ctl->fadeIn, ctl->fadeOut, n);
+    }
+}
+
+/* Recursive tone filter over the wet planes, both channels per frame */
+static void kernel_tone(spacecho_instance_t *inst, const KernelControl *ctl, int n) {
+    const float *tone = ctl->tone;
+    float *wetL = inst->scratchWetL;
+    float *wetR = inst->scratchWetR;
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    /* Both channels' filters in the two lanes */
+    OnePoleFilter *fL = &inst->toneFilter[0], *fR = &inst->toneFilter[1];
+    float32x2_t a0 = vset_lane_f32(fR->a0, vdup_n_f32(fL->a0), 1);
+    float32x2_t b1 = vset_lane_f32(fR->b1, vdup_n_f32(fL->b1), 1);
+    float32x2_t z1 = vset_lane_f32(fR->z1, vdup_n_f32(fL->z1), 1);
+    for (; i < n; i++) {
+        float32x2_t d = vset_lane_f32(wetR[i], vdup_n_f32(wetL[i]), 1);
+        if (tone) {
+            b1 = vdup_n_f32(tone[i]);
+            a0 = vdup_n_f32(1.0f - tone[i]);
+        }
+        z1 = vadd_f32(vmul_f32(d, a0), vmul_f32(z1, b1));
+        wetL[i] = vget_lane_f32(z1, 0);
+        wetR[i] = vget_lane_f32(z1, 1);
+    }
+    fL->z1 = vget_lane_f32(z1, 0);
+    fR->z1 = vget_lane_f32(z1, 1);
+#endif
+    for (; i < n; i++) {
+        if (tone) {
+            OnePoleFilter_SetPole(&inst->toneFilter[0], tone[i]);
+            OnePoleFilter_SetPole(&inst->toneFilter[1], tone[i]);
+        }
+        wetL[i] = OnePoleFilter_Process(&inst->toneFilter[0], wetL[i]);
+        wetR[i] = OnePoleFilter_Process(&inst->toneFilter[1], wetR[i]);
+    }
+}
+
+#if defined(SPACECHO_HAVE_NEON) && !defined(SPACECHO_REFERENCE_KERNEL)
+/* kernel_tone for two instances at once: lanes are a.L, a.R, b.L, b.R, so
+ * the serial filter recursion of both runs in one vector */
+static void kernel_tone_pair(spacecho_instance_t *a, const KernelControl *ctlA,
+                             spacecho_instance_t *b, const KernelControl *ctlB, int n) {
+    float *planes[4] = { a->scratchWetL, a->scratchWetR, b->scratchWetL, b->scratchWetR };
+    OnePoleFilter *f[4] = { &a->toneFilter[0], &a->toneFilter[1], &b->toneFilter[0], &b->toneFilter[1] };
+    float a0s[4], b1s[4], z1s[4];
+    for (int k = 0; k < 4; k++) {
+        a0s[k] = f[k]->a0;
+        b1s[k] = f[k]->b1;
+        z1s[k] = f[k]->z1;
+    }
+    float32x4_t a0 = vld1q_f32(a0s), b1 = vld1q_f32(b1s), z1 = vld1q_f32(z1s);
+    const float *toneA = ctlA->tone, *toneB = ctlB->tone;
+    for (int i = 0; i < n; i++) {
+        if (toneA || toneB) {
+            float poles[4] = { b1s[0], b1s[1], b1s[2], b1s[3] };
+            if (toneA) poles[0] = poles[1] = toneA[i];
+            if (toneB) poles[2] = poles[3] = toneB[i];
+            b1 = vld1q_f32(poles);
+            a0 = vsubq_f32(vdupq_n_f32(1.0f), b1);
+        }
+        float in[4] = { planes[0][i], planes[1][i], planes[2][i], planes[3][i] };
+        z1 = vaddq_f32(vmulq_f32(vld1q_f32(in), a0), vmulq_f32(z1, b1));
+        float out[4];
+        vst1q_f32(out, z1);
+        planes[0][i] = out[0];
+        planes[1][i] = out[1];
+        planes[2][i] = out[2];
+        planes[3][i] = out[3];
+    }
+    vst1q_f32(z1s, z1);
+    for (int k = 0; k < 4; k++) f[k]->z1 = z1s[k];
+}
+#endif
+
+static float kernel_peak(const float *x, int n) {
+    float peak = 0.0f;
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(x + i)));
+    }
+    peak = vmaxvq_f32(acc);
+#endif
+    for (; i < n; i++) {
+        peak = fmaxf(peak, fabsf(x[i]));
+    }
+    return peak;
+}
+
+/* Width-dependent ping-pong input routing plus cross-feedback, then write */
+static void kernel_feedback_write(spacecho_instance_t *inst, const KernelControl *ctl, int n) {
+    const float *inL = inst->scratchInL, *inR = inst->scratchInR;
+    const float *wetL = inst->scratchWetL, *wetR = inst->scratchWetR;
+    const float *fb = inst->scratchFeedback, *width = inst->scratchWidth;
+    float *wrL = inst->scratchWriteL, *wrR = inst->scratchWriteR;
+    int i = 0;
+    if (!ctl->ramping) {
+        const float f = ctl->feedback, w = ctl->width, dry = 1.0f - ctl->width;
+#ifdef SPACECHO_HAVE_NEON
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        for (; i + 4 <= n; i += 4) {
+            float32x4_t l = vld1q_f32(inL + i), r = vld1q_f32(inR + i);
+            float32x4_t mono = vmulq_f32(half, vaddq_f32(l, r));
+            float32x4_t pingL = vmulq_n_f32(r, dry);
+            float32x4_t pingR = vaddq_f32(vmulq_n_f32(l, dry), vmulq_n_f32(mono, w));
+            vst1q_f32(wrL + i, vaddq_f32(pingL, vmulq_n_f32(vld1q_f32(wetR + i), f)));
+            vst1q_f32(wrR + i, vaddq_f32(pingR, vmulq_n_f32(vld1q_f32(wetL + i), f)));
+        }
+#endif
+        for (; i < n; i++) {
+            float monoInput = 0.5f * (inL[i] + inR[i]);
+            wrL[i] = inR[i] * dry + wetR[i] * f;
+            wrR[i] = inL[i] * dry + monoInput * w + wetL[i] * f;
+        }
+    }
+#ifdef SPACECHO_HAVE_NEON
+    const float32x4_t half = vdupq_n_f32(0.5f), one = vdupq_n_f32(1.0f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t l = vld1q_f32(inL + i), r = vld1q_f32(inR + i);
+        float32x4_t w = vld1q_f32(width + i), f = vld1q_f32(fb + i);
+        float32x4_t dry = vsubq_f32(one, w);
+        float32x4_t mono = vmulq_f32(half, vaddq_f32(l, r));
+        float32x4_t pingL = vmulq_f32(r, dry);
+        float32x4_t pingR = vaddq_f32(vmulq_f32(l, dry), vmulq_f32(mono, w));
+        vst1q_f32(wrL + i, vaddq_f32(pingL, vmulq_f32(vld1q_f32(wetR + i), f)));
+        vst1q_f32(wrR + i, vaddq_f32(pingR, vmulq_f32(vld1q_f32(wetL + i), f)));
+    }
+#endif
+    for (; i < n; i++) {
+        float monoInput = 0.5f * (inL[i] + inR[i]);
+        float pingInputL = inR[i] * (1.0f - width[i]);
+        float pingInputR = inL[i] * (1.0f - width[i]) + monoInput * width[i];
+        wrL[i] = pingInputL + wetR[i] * fb[i];
+        wrR[i] = pingInputR + wetL[i] * fb[i];
+    }
+    if (inst->oversampling != OVERSAMPLING_OFF) {
+        saturate_oversampled(inst, 0, wrL, ctl->drive, ctl->driveGain, n);
+        saturate_oversampled(inst, 1, wrR, ctl->drive, ctl->driveGain, n);
+    } else if (ctl->drive || ctl->driveGain != 1.0f) {
+        SoftClip_Block(wrL, ctl->drive, ctl->driveGain, n);
+        SoftClip_Block(wrR, ctl->drive, ctl->driveGain, n);
+    }
+#ifdef DENORMAL_DC
+    for (i = 0; i < n; i++) {
+        wrL[i] += DENORMAL_DC;
+        wrR[i] += DENORMAL_DC;
+    }
+#endif
+    StereoDelayLine_WriteBlock(&inst->delayLine, wrL, wrR, n);
+
+    /* Tail tracking: peak of what went into the delay line */
+    float peak = kernel_peak(wrL, n);
+    float peakR = kernel_peak(wrR, n);
+    if (peakR > peak) peak = peakR;
+    inst->tailPeak = peak;
+    if (peak < TAIL_SILENCE_THRESHOLD) {
+        inst->tailSilentFrames += n;
+        if (inst->tailSilentFrames > inst->delayLine.bufferLength) {
+            inst->tailSilentFrames = inst->delayLine.bufferLength;
+        }
+    } else {
+        inst->tailSilentFrames = 0;
+    }
+}
+
+/* Wet stereo width and level compensation, in place on the wet planes */
+static void kernel_width(spacecho_instance_t *inst, const KernelControl *ctl, int n) {
+    float *wetL = inst->scratchWetL, *wetR = inst->scratchWetR;
+    const float *width = inst->scratchWidth;
+    for (int start = 0; start < n; start += CONTROL_RATE_FRAMES) {
+        int end = start + CONTROL_RATE_FRAMES < n ? start + CONTROL_RATE_FRAMES : n;
+        /* Level compensation at the segment ends, linear in between */
+        float comp = ctl->widthComp, compStep = 0.0f;
+        if (ctl->ramping) {
+            comp = GetWidthLevelComp(width[start]);
+            if (end - start > 1) {
+                compStep = (GetWidthLevelComp(width[end - 1]) - comp) / (float)(end - start - 1);
+            }
+        }
+        int i = start;
+#ifdef SPACECHO_HAVE_NEON
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        const float laneSteps[4] = { 0.0f, compStep, 2.0f * compStep, 3.0f * compStep };
+        const float32x4_t compLanes = vld1q_f32(laneSteps);
+        for (; i + 4 <= end; i += 4) {
+            float32x4_t dL = vld1q_f32(wetL + i), dR = vld1q_f32(wetR + i);
+            float32x4_t w = ctl->ramping ? vld1q_f32(width + i) : vdupq_n_f32(ctl->width);
+            float32x4_t wetMono = vmulq_f32(half, vaddq_f32(dL, dR));
+            float32x4_t wL = vaddq_f32(wetMono, vmulq_f32(vsubq_f32(dL, wetMono), w));
+            float32x4_t wR = vaddq_f32(wetMono, vmulq_f32(vsubq_f32(dR, wetMono), w));
+            float32x4_t c = vaddq_f32(vdupq_n_f32(comp + compStep * (float)(i - start)), compLanes);
+            vst1q_f32(wetL + i, vmulq_f32(wL, c));
+            vst1q_f32(wetR + i, vmulq_f32(wR, c));
+        }
+#endif
+        for (; i < end; i++) {
+            float w = ctl->ramping ? width[i] : ctl->width;
+            float wetMono = 0.5f * (wetL[i] + wetR[i]);
+            float wL = wetMono + (wetL[i] - wetMono) * w;
+            float wR = wetMono + (wetR[i] - wetMono) * w;
+            float c = comp + compStep * (float)(i - start);
+            wetL[i] = wL * c;
+            wetR[i] = wR * c;
+        }
+    }
+}
+
+/* Wet planes *= the ducking gains */
+static void kernel_duck(spacecho_instance_t *inst, int n) {
+    float *wetL = inst->scratchWetL, *wetR = inst->scratchWetR;
+    const float *gain = inst->scratchDuck;
+    int i = 0;
+#ifdef SPACECHO_HAVE_NEON
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t g = vld1q_f32(gain + i);
+        vst1q_f32(wetL + i, vmulq_f32(vld1q_f32(wetL + i), g));
+        vst1q_f32(wetR + i, vmulq_f32(vld1q_f32(wetR + i), g));
+    }
+#endif
+    for (; i < n; i++) {
+        wetL[i] *= gain[i];
+        wetR[i] *= gain[i];
+    }
+}
+
+/* Dry/wet mix (output replaces input) */
+static void kernel_mix(spacecho_instance_t *inst, const KernelControl *ctl, int n) {
+    float *inL = inst->scratchInL, *inR = inst->scratchInR;
+    const float *wetL = inst->scratchWetL, *wetR = inst->scratchWetR;
+    const float *mix = inst->scratchMix;
+    int i = 0;
+    if (!ctl->ramping) {
+        const float m = ctl->mix, dry = 1.0f - ctl->mix;
+#ifdef SPACECHO_HAVE_NEON
+        for (; i + 4 <= n; i += 4) {
+            vst1q_f32(inL + i, vaddq_f32(vmulq_n_f32(vld1q_f32(inL + i), dry), vmulq_n_f32(vld1q_f32(wetL + i), m)));
+            vst1q_f32(inR + i, vaddq_f32(vmulq_n_f32(vld1q_f32(inR + i), dry), vmulq_n_f32(vld1q_f32(wetR + i), m)));
+        }
+#endif
+        for (; i < n; i++) {
+            inL[i] = inL[i] * dry + wetL[i] * m;
+            inR[i] = inR[i] * dry + wetR[i] * m;
+        }
+        return;
+    }
+#ifdef SPACECHO_HAVE_NEON
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t m = vld1q_f32(mix + i);
+        float32x4_t dry = vsubq_f32(one, m);
+        vst1q_f32(inL + i, vaddq_f32(vmulq_f32(vld1q_f32(inL + i), dry), vmulq_f32(vld1q_f32(wetL + i), m)));
+        vst1q_f32(inR + i, vaddq_f32(vmulq_f32(vld1q_f32(inR + i), dry), vmulq_f32(vld1q_f32(wetR + i), m)));
+    }
+#endif
+    for (; i < n; i++) {
+        inL[i] = inL[i] * (1.0f - mix[i]) + wetL[i] * mix[i];
+        inR[i] = inR[i] * (1.0f - mix[i]) + wetR[i] * mix[i];
+    }
+}
+
+/* Advance tap ramps without reading (bypass / muted wet) */
+static void kernel_taps_advance(spacecho_instance_t *inst, int n) {
+    for (int t = 0; t < inst->activeTaps; t++) {
+        SmoothedValue_Advance(&inst->taps[t].smoothedTime, n);
+        SmoothedValue_Advance(&inst->taps[t].smoothedGainL, n);
+        SmoothedValue_Advance(&inst->taps[t].smoothedGainR, n);
+    }
+}
+
+/* Multi-tap playback heads: one gather pass over the shared buffer for all
+ * taps, each tap mono-summed and equal-power panned into a tap bus that gets
+ * its own tone filter. Runs before the chunk is written; the flutter offset
+ * and a ramping tone pole come per frame from ctl. */
+static void kernel_taps(spacecho_instance_t *inst, const KernelControl *ctl, int n) {
+    const StereoDelayLine *dl = &inst->delayLine;
+    const float *mod = ctl->mod, *tone = ctl->tone;
+    float *tapL = inst->scratchTapL, *tapR = inst->scratchTapR;
+    const int count = inst->activeTaps;
+    const uint32_t phaseStep = 1u << dl->fracBits;
+
+    /* Per-chunk fixed-point delay start/step and gains, padded to TAP_LANES */
+    uint32_t delayQ[MAX_TAPS], delayStep[MAX_TAPS];
+    float gainL[MAX_TAPS], gainR[MAX_TAPS];
+    float *state[MAX_TAPS];
+    float padState[2] = { 0.0f, 0.0f };
+    for (int t = 0; t < MAX_TAPS; t++) {
+        if (t < count) {
+            DelayTap *tap = &inst->taps[t];
+            state[t] = tap->allpassState;
+            uint32_t q0 = StereoDelayLine_DelayToPhase(dl, tap->smoothedTime.currentValue * dl->sampleRate);
+            SmoothedValue_Advance(&tap->smoothedTime, n);
+            uint32_t q1 = StereoDelayLine_DelayToPhase(dl, tap->smoothedTime.currentValue * dl->sampleRate);
+            delayQ[t] = q0;
+            delayStep[t] = (uint32_t)((int32_t)(q1 - q0) / n);
+            SmoothedValue_Advance(&tap->smoothedGainL, n);
+            SmoothedValue_Advance(&tap->smoothedGainR, n);
+            gainL[t] = tap->smoothedGainL.currentValue;
+            gainR[t] = tap->smoothedGainR.currentValue;
+        } else {
+            delayQ[t] = phaseStep;
+            delayStep[t] = 0;
+            gainL[t] = 0.0f;
+            gainR[t] = 0.0f;
+            state[t] = padState;
+        }
+    }
+
+    uint32_t writePhase = StereoDelayLine_WritePhase(dl, 0);
+    const float modScale = dl->sampleRate * dl->phaseScale;
+#ifdef SPACECHO_HAVE_NEON
+    const int groups = (count + 3) / 4;
+    const int32x4_t indexShift = vdupq_n_s32(-dl->fracBits);
+    const uint32x4_t fracMask = vdupq_n_u32(dl->fracMask);
+    uint32x4_t dq[MAX_TAPS / 4], dqStep[MAX_TAPS / 4];
+    float32x4_t gL[MAX_TAPS / 4], gR[MAX_TAPS / 4];
+    for (int g = 0; g < groups; g++) {
+        dq[g] = vld1q_u32(delayQ + g * 4);
+        dqStep[g] = vld1q_u32(delayStep + g * 4);
+        gL[g] = vmulq_n_f32(vld1q_f32(gainL + g * 4), 0.5f);  /* folds the mono 0.5 */
+        gR[g] = vmulq_n_f32(vld1q_f32(gainR + g * 4), 0.5f);
+    }
+    for (int i = 0; i < n; i++) {
+        float32x4_t accL = vdupq_n_f32(0.0f), accR = vdupq_n_f32(0.0f);
+        uint32_t headPhase = writePhase;
+        if (mod) headPhase -= (uint32_t)(int32_t)(mod[i] * modScale);
+        for (int g = 0; g < groups; g++) {
+            uint32x4_t phase = vsubq_u32(vdupq_n_u32(headPhase), dq[g]);
+            dq[g] = vaddq_u32(dq[g], dqStep[g]);
+            uint32_t index[4];
+            float fraction[4];
+            vst1q_u32(index, vshlq_u32(phase, indexShift));
+            vst1q_f32(fraction, vmulq_n_f32(vcvtq_f32_u32(vandq_u32(phase, fracMask)), dl->fracScale));
+
+            float32x4_t mono = vdupq_n_f32(0.0f);
+            for (int k = 0; k < 4; k++) {
+                float32x2_t d = StereoDelayLine_InterpolateNeon(dl, index[k], fraction[k], state[g * 4 + k]);
+                mono = vsetq_lane_f32(vget_lane_f32(vpadd_f32(d, d), 0), mono, k);
+            }
+            accL = vmlaq_f32(accL, mono, gL[g]);
+            accR = vmlaq_f32(accR, mono, gR[g]);
+        }
+        tapL[i] = vaddvq_f32(accL);
+        tapR[i] = vaddvq_f32(accR);
+        writePhase += phaseStep;
+    }
+#else
+    for (int i = 0; i < n; i++) {
+        float accL = 0.0f, accR = 0.0f;
+        uint32_t headPhase = writePhase;
+        if (mod) headPhase -= (uint32_t)(int32_t)(mod[i] * modScale);
+        for (int t = 0; t < count; t++) {
+            float l, r;
+            StereoDelayLine_ReadPhase(dl, headPhase - delayQ[t], state[t], &l, &r);
+            delayQ[t] += delayStep[t];
+            float mono = 0.5f * (l + r);
+            accL += mono * gainL[t];
+            accR += mono * gainR[t];
+        }
+        tapL[i] = accL;
+        tapR[i] = accR;
+        writePhase += phaseStep;
+    }
+#endif
+
+    for (int i = 0; i < n; i++) {
+        if (tone) {
+            OnePoleFilter_SetPole(&inst->tapToneFilter[0], tone[i]);
+            OnePoleFilter_SetPole(&inst->tapToneFilter[1], tone[i]);
+        }
+        tapL[i] = OnePoleFilter_Process(&inst->tapToneFilter[0], tapL[i]);
+        tapR[i] = OnePoleFilter_Process(&inst->tapToneFilter[1], tapR[i]);
+    }
+}
+
+/* ============================================================================
+ * LAZY BYPASS - Skip work once the echo is provably inaudible
+ * ============================================================================ */
+
+static int kernel_input_silent(const int16_t *audio, int n) {
+    int16_t acc = 0;
+    for (int i = 0; i < n * 2; i++) {
+        acc |= audio[i];
+    }
+    return acc == 0;
+}
+
+#ifndef SPACECHO_REFERENCE_KERNEL
+static int kernel_input_silent_f32(const float *l, const float *r, int stride, int n) {
+    int silent = 1;
+    for (int i = 0; i < n; i++) {
+        silent &= (l[i * stride] == 0.0f) & (r[i * stride] == 0.0f);
+    }
+    return silent;
+}
+#endif
+
+/* True when every sample the read head can reach, and the tone filter state,
+ * is below TAIL_SILENCE_THRESHOLD */
+static int kernel_tail_inaudible(const spacecho_instance_t *inst) {
+    float maxDelay = fmaxf(inst->smoothedDelayTime.currentValue, inst->smoothedDelayTime.targetValue);
+    if (inst->fadeRemaining > 0) maxDelay = fmaxf(maxDelay, inst->fadeFromSamples / inst->sampleRate);
+    for (int t = 0; t < inst->activeTaps; t++) {
+        const SmoothedValue *tapTime = &inst->taps[t].smoothedTime;
+        maxDelay = fmaxf(maxDelay, fmaxf(tapTime->currentValue, tapTime->targetValue));
+    }
+    if (playback_active(inst)) {
+        maxDelay = fmaxf(maxDelay, (float)inst->grainLength / inst->sampleRate) * PLAYBACK_REACH;
+    }
+    maxDelay += inst->flutter.flutterDepth + inst->flutter.wowDepth;
+    int reach = (int)(maxDelay * inst->sampleRate) + 1 + INTERP_LOOKAHEAD;
+    if (inst->tailSilentFrames < reach) return 0;
+    for (int ch = 0; ch < MAX_CHANNELS; ch++) {
+        if (fabsf(inst->toneFilter[ch].z1) >= TAIL_SILENCE_THRESHOLD) return 0;
+        if (fabsf(inst->tapToneFilter[ch].z1) >= TAIL_SILENCE_THRESHOLD) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Silent input with an inaudible tail: the full kernel would output zeros, so
+ * leave the (zero) block untouched. Zeros are still written until the whole
+ * buffer is clean so that a later, longer delay time cannot reach stale audio;
+ * after that nothing is touched at all.
+ */
+static void kernel_bypass_chunk(spacecho_instance_t *inst, int n) {
+    SmoothedValue_Advance(&inst->smoothedDelayTime, n);
+    SmoothedValue_Advance(&inst->smoothedFeedback, n);
+    SmoothedValue_Advance(&inst->smoothedDrive, n);
+    SmoothedValue_Advance(&inst->smoothedMix, n);
+    SmoothedValue_Advance(&inst->smoothedStereoWidth, n);
+    kernel_taps_advance(inst, n);
+    FlutterLFO_Advance(&inst->flutter, n);
+    inst->fadeRemaining = 0;  /* nothing audible to crossfade */
+    if (playback_active(inst)) playback_read(inst, NULL, NULL, n);
+    if (inst->duck.depth > 0.0f) DuckFollower_Fill(&inst->duck, NULL, NULL, NULL, n);
+    if (inst->fadePending >= 0.0f) {
+        SmoothedValue_SetTarget(&inst->smoothedDelayTime, inst->fadePending, 0);
+        inst->fadePending = -1.0f;
+    }
+    if (inst->smoothedTone.stepsRemaining > 0) {
+        SmoothedValue_Advance(&inst->smoothedTone, n);
+        set_tone_pole(inst, ToneTable_Lookup(&inst->toneTable, inst->smoothedTone.currentValue));
+    }
+
+    if (inst->tailSilentFrames < inst->delayLine.bufferLength) {
+        StereoDelayLine_WriteSilence(&inst->delayLine, n);
+        inst->tailSilentFrames += n;
+        if (inst->tailSilentFrames > inst->delayLine.bufferLength) {
+            inst->tailSilentFrames = inst->delayLine.bufferLength;
+        }
+    }
+    inst->tailPeak = 0.0f;
+    for (int ch = 0; ch < MAX_CHANNELS; ch++) {
+        inst->toneFilter[ch].z1 = 0.0f;
+        inst->tapToneFilter[ch].z1 = 0.0f;
+    }
+    memset(inst->halfband, 0, sizeof(inst->halfband));
+    reset_interpolation_state(inst);
+}
+
+/* Bypass or set up the chunk's control; returns 0 when it was bypassed */
+static int kernel_chunk_enter(spacecho_instance_t *inst, KernelControl *ctl, int input_silent, int n) {
+    if (input_silent && !inst->frozen && kernel_tail_inaudible(inst)) {
+        kernel_bypass_chunk(inst, n);
+        return 0;
+    }
+
+    /* Mix settled at 0: output equals input, only keep the delay line fed */
+    int wet_muted = SmoothedValue_IsSettledAt(&inst->smoothedMix, 0.0f);
+
+    kernel_control(inst, ctl, n);
+    ctl->wetMuted = wet_muted;
+    return 1;
+}
+
+/* Chunk stages up to the tone filter; returns 0 when the chunk was bypassed */
+static int kernel_chunk_front(spacecho_instance_t *inst, KernelControl *ctl, const int16_t *audio,
+                              int16_t *out, int n) {
+    if (!kernel_chunk_enter(inst, ctl, kernel_input_silent(audio, n), n)) {
+        kernel_pass_through(audio, out, n);
+        return 0;
+    }
+    kernel_decode(audio, inst->scratchInL, inst->scratchInR, n);
+    kernel_read(inst, ctl, n);
+    return 1;
+}
+
+/* Chunk stages after the tone filter up to the mix into scratchInL/R;
+ * returns 0 when the wet path is muted and the output equals the input */
+static int kernel_chunk_mix(spacecho_instance_t *inst, const KernelControl *ctl, int n) {
+    const int taps = inst->frozen ? 0 : inst->activeTaps;  /* taps are silent while frozen */
+    if (inst->activeTaps > 0) {
+        if (ctl->wetMuted || !taps) kernel_taps_advance(inst, n);
+        else kernel_taps(inst, ctl, n);
+    }
+    if (!inst->frozen) kernel_feedback_write(inst, ctl, n);
+    const int ducking = inst->duck.depth > 0.0f;
+    if (ducking) {
+        DuckFollower_Fill(&inst->duck, inst->scratchInL, inst->scratchInR, ctl->wetMuted ? NULL : inst->scratchDuck, n);
+    }
+    if (ctl->wetMuted) return 0;
+    kernel_width(inst, ctl, n);
+    if (taps > 0) {
+        kernel_accumulate(inst->scratchWetL, inst->scratchTapL, n);
+        kernel_accumulate(inst->scratchWetR, inst->scratchTapR, n);
+    }
+    if (ducking) kernel_duck(inst, n);
+    kernel_mix(inst, ctl, n);
+#ifdef SPACECHO_PERF_STATS
+    unsigned clips = 0;
+    for (int i = 0; i < n; i++) {
+        clips += (fabsf(inst->scratchInL[i]) > 1.0f) + (fabsf(inst->scratchInR[i]) > 1.0f);
     }
+    if (clips) PerfStats_Count(&inst->perf.clips, clips);
+#endif
+    return 1;
+}
 
-    if (module_dir) {
-        strncpy(inst->module_dir, module_dir, sizeof(inst->module_dir) - 1);
-    }
+/* Chunk stages after the tone filter; in is the chunk's input, out receives
+ * the output (the same block when processing in place) */
+static void kernel_chunk_back(spacecho_instance_t *inst, const KernelControl *ctl, const int16_t *in,
+                              int16_t *out, int n) {
+    if (kernel_chunk_mix(inst, ctl, n)) kernel_encode(inst->scratchInL, inst->scratchInR, out, n);
+    else kernel_pass_through(in, out, n);
+}
 
-    /* Set default parameters */
-    inst->param_time = 400;  /* 400ms */
-    inst->param_feedback = 0.4f;
-    inst->param_mix = 0.5f;
-    inst->param_tone = 0.5f;
-    inst->param_stereo_width = 0;
-    inst->param_division = DIV_FREE;
-    inst->param_bpm = 120;
+static void kernel_process_chunk(spacecho_instance_t *inst, const int16_t *in, int16_t *out, int n) {
+    KernelControl ctl;
+    if (!kernel_chunk_front(inst, &ctl, in, out, n)) return;
+    kernel_tone(inst, &ctl, n);
+    kernel_chunk_back(inst, &ctl, in, out, n);
+}
 
-    /* Initialize delay lines */
+#ifdef SPACECHO_PERF_STATS
+/* Recursive state left subnormal at the end of a block */
+static int kernel_state_subnormal(const spacecho_instance_t *inst) {
     for (int ch = 0; ch < MAX_CHANNELS; ch++) {
-        DelayLine_Init(&inst->delayLine[ch], SAMPLE_RATE);
-        OnePoleFilter_Init(&inst->toneFilter[ch]);
-        OnePoleFilter_SetCutoff(&inst->toneFilter[ch], GetToneFrequency(inst->param_tone), SAMPLE_RATE);
+        if (fpclassify(inst->toneFilter[ch].z1) == FP_SUBNORMAL ||
+            fpclassify(inst->tapToneFilter[ch].z1) == FP_SUBNORMAL ||
+            fpclassify(inst->allpassState[ch]) == FP_SUBNORMAL) return 1;
     }
-
-    /* Initialize smoothed values */
-    SmoothedValue_Init(&inst->smoothedDelayTime, GetDelayTimeSeconds(inst->param_time));
-    SmoothedValue_Init(&inst->smoothedFeedback, GetFeedback(inst->param_feedback));
-    SmoothedValue_Init(&inst->smoothedMix, inst->param_mix);
-    SmoothedValue_Init(&inst->smoothedTone, inst->param_tone);
-    SmoothedValue_Init(&inst->smoothedStereoWidth, GetStereoWidth(inst->param_stereo_width));
-
-    inst->initialized = 1;
-    plugin_log("Instance created");
-    return inst;
+    return 0;
 }
+#endif
 
-static void v2_destroy_instance(void *instance) {
-    spacecho_instance_t *inst = (spacecho_instance_t*)instance;
-    if (!inst) return;
-
-    plugin_log("Destroying instance");
+/* One block from in to out (which may be the same buffer) */
+static void kernel_run_io(spacecho_instance_t *inst, const int16_t *in, int16_t *out, int frames) {
+#ifdef SPACECHO_PERF_STATS
+    uint64_t start = perf_now();
+#endif
+    drain_param_queue(inst);
+    for (int offset = 0; offset < frames; offset += inst->chunkFrames) {
+        int n = frames - offset;
+        if (n > inst->chunkFrames) n = inst->chunkFrames;
+        kernel_process_chunk(inst, in + offset * 2, out + offset * 2, n);
+    }
+#ifdef SPACECHO_PERF_STATS
+    PerfStats_Record(&inst->perf, start, perf_now(), frames);
+    if (kernel_state_subnormal(inst)) PerfStats_Count(&inst->perf.denormals, 1);
+#endif
+}
 
-    if (inst->initialized) {
-        for (int ch = 0; ch < MAX_CHANNELS; ch++) {
-            DelayLine_Free(&inst->delayLine[ch]);
-        }
+#ifndef SPACECHO_REFERENCE_KERNEL
+/* One float block in place (process_block_f32); a muted wet path or a
+ * bypassed chunk leaves the buffers untouched */
+static void kernel_run_f32(spacecho_instance_t *inst, float *left, float *right, int stride, int frames) {
+#ifdef SPACECHO_PERF_STATS
+    uint64_t start = perf_now();
+#endif
+    drain_param_queue(inst);
+    for (int offset = 0; offset < frames; offset += inst->chunkFrames) {
+        int n = frames - offset;
+        if (n > inst->chunkFrames) n = inst->chunkFrames;
+        float *l = left + (size_t)offset * stride, *r = right + (size_t)offset * stride;
+        KernelControl ctl;
+        if (!kernel_chunk_enter(inst, &ctl, kernel_input_silent_f32(l, r, stride, n), n)) continue;
+        kernel_load_f32(l, r, stride, inst->scratchInL, inst->scratchInR, n);
+        kernel_read(inst, &ctl, n);
+        kernel_tone(inst, &ctl, n);
+        if (kernel_chunk_mix(inst, &ctl, n)) kernel_store_f32(inst->scratchInL, inst->scratchInR, l, r, stride, n);
     }
+#ifdef SPACECHO_PERF_STATS
+    PerfStats_Record(&inst->perf, start, perf_now(), frames);
+    if (kernel_state_subnormal(inst)) PerfStats_Count(&inst->perf.denormals, 1);
+#endif
+}
+#endif
 
-    free(inst);
+/* One block through the kernel in place; on the worker thread when offloaded */
+static void kernel_run_block(void *instance, int16_t *audio_inout, int frames) {
+    kernel_run_io((spacecho_instance_t*)instance, audio_inout, audio_inout, frames);
 }
 
+#ifndef SPACECHO_REFERENCE_KERNEL
 static void v2_process_block(void *instance, int16_t *audio_inout, int frames) {
     spacecho_instance_t *inst = (spacecho_instance_t*)instance;
     if (!inst || !inst->initialized) return;
+    const int16_t *in;
+    int16_t *out;
+    if (!MappedIo_Resolve(&inst->mapped, audio_inout, frames, &in, &out)) return;
 
-    /* Track samples for MIDI clock BPM detection */
-    inst->clock_sample_counter += frames;
+    /* Time base for MIDI clock tick stamps */
+    inst->clock_sample_pos += frames;
 
-    for (int i = 0; i < frames; i++) {
-        /* Get smoothed parameter values */
-        float delayTime = SmoothedValue_GetNext(&inst->smoothedDelayTime);
-        float feedback = SmoothedValue_GetNext(&inst->smoothedFeedback);
-        float mix = SmoothedValue_GetNext(&inst->smoothedMix);
-        float stereoWidth = SmoothedValue_GetNext(&inst->smoothedStereoWidth);
+    if (inst->worker.running) {
+        /* The worker exchanges whole blocks in place */
+        kernel_pass_through(in, out, frames);
+        Worker_Exchange(&inst->worker, out, frames);
+        return;
+    }
+    uint64_t fpMode = ftz_enter();
+    kernel_run_io(inst, in, out, frames);
+    ftz_leave(fpMode);
+}
+#endif
 
-        /* Convert input to float */
-        float inL = audio_inout[i * 2] / 32768.0f;
-        float inR = audio_inout[i * 2 + 1] / 32768.0f;
+/* ============================================================================
+ * BATCH - Several instances over the same block in one call
+ *
+ * Instances advance chunk by chunk in lockstep: every instance runs its front
+ * stages, then the tone filters (the serial recursion of the kernel) run two
+ * instances per 4-lane vector with the instances' state laid out across lanes,
+ * then every instance runs its back stages. Output matches per-instance
+ * process_block calls exactly.
+ * ============================================================================ */
 
-        /* Read from delay lines */
-        float delayedL = DelayLine_Read(&inst->delayLine[0], delayTime);
-        float delayedR = DelayLine_Read(&inst->delayLine[1], delayTime);
+#define BATCH_MAX 16  /* instances in flight at once; larger batches are split */
 
-        /* Apply tone filter to delayed signal */
-        delayedL = OnePoleFilter_Process(&inst->toneFilter[0], delayedL);
-        delayedR = OnePoleFilter_Process(&inst->toneFilter[1], delayedR);
+#ifndef SPACECHO_REFERENCE_KERNEL
+static void process_batch(spacecho_instance_t *const *insts, int16_t *const *audio, int count, int frames) {
+    KernelControl ctl[BATCH_MAX];
+    spacecho_instance_t *live[BATCH_MAX];
+    int16_t *liveAudio[BATCH_MAX];
+    int liveCount = 0;
+    int chunk = frames;
+#ifdef SPACECHO_PERF_STATS
+    uint64_t start = perf_now();
+#endif
 
-        /*
-         * Width-dependent ping-pong input routing:
-         * - width=0.0: original crossfeed behavior (preserves previous mono-width level)
-         * - width=1.0: mono-seeded ping-pong (centered mono input still alternates L/R)
-         */
-        float monoInput = 0.5f * (inL + inR);
-        float pingInputL = inR * (1.0f - stereoWidth);
-        float pingInputR = inL * (1.0f - stereoWidth) + monoInput * stereoWidth;
-        DelayLine_Write(&inst->delayLine[0], pingInputL + delayedR * feedback);
-        DelayLine_Write(&inst->delayLine[1], pingInputR + delayedL * feedback);
+    for (int k = 0; k < count; k++) {
+        spacecho_instance_t *inst = insts[k];
+        if (!inst || !inst->initialized || !audio[k]) continue;
+        if (inst->worker.running) {
+            /* Offloaded instances run on their own worker instead */
+            inst->clock_sample_pos += frames;
+            Worker_Exchange(&inst->worker, audio[k], frames);
+            continue;
+        }
+        drain_param_queue(inst);
+        inst->clock_sample_pos += frames;
+        if (inst->chunkFrames < chunk) chunk = inst->chunkFrames;
+        live[liveCount] = inst;
+        liveAudio[liveCount++] = audio[k];
+    }
 
-        /* Stereo width on wet path: 0 = mono, 1 = full L/R */
-        float wetMono = 0.5f * (delayedL + delayedR);
-        float wetL = wetMono + (delayedL - wetMono) * stereoWidth;
-        float wetR = wetMono + (delayedR - wetMono) * stereoWidth;
+    for (int offset = 0; offset < frames; offset += chunk) {
+        int n = frames - offset;
+        if (n > chunk) n = chunk;
 
-        /* Keep perceived wet level more stable while widening. */
-        float widthLevelComp = 1.0f / sqrtf(1.0f - 0.5f * stereoWidth);
-        if (widthLevelComp > 1.333333f) widthLevelComp = 1.333333f;
-        wetL *= widthLevelComp;
-        wetR *= widthLevelComp;
+        /* Front stages; ready[] packs the instances that were not bypassed */
+        int ready[BATCH_MAX];
+        int readyCount = 0;
+        for (int k = 0; k < liveCount; k++) {
+            int16_t *chunkAudio = liveAudio[k] + offset * 2;
+            if (kernel_chunk_front(live[k], &ctl[k], chunkAudio, chunkAudio, n)) ready[readyCount++] = k;
+        }
 
-        /* Mix dry/wet */
-        float outL = inL * (1.0f - mix) + wetL * mix;
-        float outR = inR * (1.0f - mix) + wetR * mix;
+        int r = 0;
+#ifdef SPACECHO_HAVE_NEON
+        for (; r + 2 <= readyCount; r += 2) {
+            kernel_tone_pair(live[ready[r]], &ctl[ready[r]], live[ready[r + 1]], &ctl[ready[r + 1]], n);
+        }
+#endif
+        for (; r < readyCount; r++) {
+            kernel_tone(live[ready[r]], &ctl[ready[r]], n);
+        }
 
-        /* Soft clip output */
-        if (outL > 1.0f) outL = 1.0f;
-        if (outL < -1.0f) outL = -1.0f;
-        if (outR > 1.0f) outR = 1.0f;
-        if (outR < -1.0f) outR = -1.0f;
+        for (r = 0; r < readyCount; r++) {
+            int k = ready[r];
+            int16_t *chunkAudio = liveAudio[k] + offset * 2;
+            kernel_chunk_back(live[k], &ctl[k], chunkAudio, chunkAudio, n);
+        }
+    }
 
-        /* Convert back to int16 */
-        audio_inout[i * 2] = (int16_t)(outL * 32767.0f);
-        audio_inout[i * 2 + 1] = (int16_t)(outR * 32767.0f);
+#ifdef SPACECHO_PERF_STATS
+    /* Lockstep instances share the group's time evenly */
+    if (liveCount) {
+        uint64_t share = (perf_now() - start) / (uint64_t)liveCount;
+        for (int k = 0; k < liveCount; k++) {
+            PerfStats_Record(&live[k]->perf, 0, share, frames);
+            if (kernel_state_subnormal(live[k])) PerfStats_Count(&live[k]->perf.denormals, 1);
+        }
+    }
+#endif
+}
+#endif
+
+/* set_param thread: report the synced heads' times at param_bpm and reserve
+ * the buffer they reach. The audio thread times the heads itself from the
+ * divisions and tempo it was sent, so nothing is posted here. */
+static void refresh_synced_times(spacecho_instance_t *inst) {
+    float ms = compute_synced_time(inst->param_bpm, inst->param_division);
+    if (ms > 0.0f) {
+        inst->param_time = (int)(ms + 0.5f);
+        float reach = ms * 0.001f * (inst->param_playback != PLAYBACK_FORWARD ? PLAYBACK_REACH : 1.0f);
+        DelayGrowth_Reserve(&inst->delayGrowth, delay_length_for(inst, reach));
+    }
+    for (int t = 0; t < MAX_TAPS; t++) {
+        DelayTap *tap = &inst->taps[t];
+        float tap_ms = compute_synced_time(inst->param_bpm, tap->param_division);
+        if (tap_ms > 0.0f) {
+            tap->param_time = (int)(tap_ms + 0.5f);
+            DelayGrowth_Reserve(&inst->delayGrowth, delay_length_for(inst, tap_ms * 0.001f));
+        }
+    }
+}
+
+/* set_param thread: take the tempo the MIDI clock last published into param_bpm */
+static void pull_clock_tempo(spacecho_instance_t *inst) {
+    uint64_t tempo = atomic_load_explicit(&inst->clockTempo, memory_order_acquire);
+    if ((uint32_t)(tempo >> 32) == inst->clockSeen) return;
+    inst->clockSeen = (uint32_t)(tempo >> 32);
+    inst->param_bpm = clock_tempo_bpm(tempo);
+    refresh_synced_times(inst);
+}
+
+/* Ramp the tone; the audio thread looks the filter pole up from the table */
+static void apply_tone(spacecho_instance_t *inst) {
+    post_param(inst, PARAM_EVENT_TONE, 0, inst->param_tone, 0.0f);
+}
+
+/* Post a tap's equal-power gains after a gain or pan change */
+static void post_tap_gains(spacecho_instance_t *inst, int index) {
+    float gainL, gainR;
+    DelayTap_PanGains(&inst->taps[index], &gainL, &gainR);
+    post_param(inst, PARAM_EVENT_TAP_GAINS, index, gainL, gainR);
+}
+
+/* Set one tap field from its numeric value (division as an option index) */
+static void set_tap_number(spacecho_instance_t *inst, int index, int field, float v) {
+    DelayTap *tap = &inst->taps[index];
+    if (field == TAP_FIELD_TIME) {
+        int ms = (int)v;
+        if (ms < 20) ms = 20;
+        if (ms > 2000) ms = 2000;
+        tap->param_time = ms;
+        if (tap->param_division != DIV_FREE) {
+            tap->param_division = DIV_FREE; /* manual override reverts sync */
+            post_param(inst, PARAM_EVENT_TAP_DIVISION, index, (float)DIV_FREE, 0.0f);
+        }
+        post_param(inst, PARAM_EVENT_TAP_TIME, index, GetDelayTimeSeconds(ms), 0.0f);
+    }
+    else if (field == TAP_FIELD_DIVISION) {
+        int div = (int)v;
+        if (div < 0) div = 0;
+        if (div >= DIV_COUNT) div = DIV_COUNT - 1;
+        tap->param_division = div;
+        refresh_synced_times(inst);
+        post_param(inst, PARAM_EVENT_TAP_DIVISION, index, (float)div, 0.0f);
+    }
+    else if (field == TAP_FIELD_GAIN) {
+        if (v < 0.0f) v = 0.0f;
+        if (v > 1.0f) v = 1.0f;
+        tap->param_gain = v;
+        post_tap_gains(inst, index);
     }
+    else if (field == TAP_FIELD_PAN) {
+        if (v < -1.0f) v = -1.0f;
+        if (v > 1.0f) v = 1.0f;
+        tap->param_pan = v;
+        post_tap_gains(inst, index);
+    }
+}
+
+static int get_tap_param(const spacecho_instance_t *inst, int index, int field, char *buf, int buf_len) {
+    const DelayTap *tap = &inst->taps[index];
+    switch (field) {
+    case TAP_FIELD_TIME: return snprintf(buf, buf_len, "%d", tap->param_time);
+    case TAP_FIELD_DIVISION: return snprintf(buf, buf_len, "%s", division_names[tap->param_division]);
+    case TAP_FIELD_GAIN: return snprintf(buf, buf_len, "%.2f", tap->param_gain);
+    case TAP_FIELD_PAN: return snprintf(buf, buf_len, "%.2f", tap->param_pan);
+    }
+    return -1;
 }
 
+/* Set a settable param by ID from its numeric value (enums as option index) */
+static void set_param_number(spacecho_instance_t *inst, int id, float v) {
+    if (id >= PARAM_TAP_FIRST && id <= PARAM_TAP_LAST) {
+        set_tap_number(inst, (id - PARAM_TAP_FIRST) / TAP_FIELD_COUNT, (id - PARAM_TAP_FIRST) % TAP_FIELD_COUNT, v);
+        return;
+    }
 
-/* Apply synced delay time if division is active */
-static void apply_synced_time(spacecho_instance_t *inst) {
-    int ms = compute_synced_time(inst->param_bpm, inst->param_division);
-    if (ms > 0) {
+    switch (id) {
+    case PARAM_TIME: {
+        int ms = (int)v;
+        if (ms < 20) ms = 20;
+        if (ms > 2000) ms = 2000;
         inst->param_time = ms;
-        SmoothedValue_SetTarget(&inst->smoothedDelayTime, GetDelayTimeSeconds(ms), RAMP_SAMPLES);
+        if (inst->param_division != DIV_FREE) {
+            inst->param_division = DIV_FREE; /* manual override reverts sync */
+            post_param(inst, PARAM_EVENT_DIVISION, 0, (float)DIV_FREE, 0.0f);
+        }
+        post_param(inst, PARAM_EVENT_DELAY_TIME, 0, GetDelayTimeSeconds(ms), 0.0f);
+        return;
+    }
+    case PARAM_STEREO_WIDTH: {
+        int width = (int)v;
+        if (width < 0) width = 0;
+        if (width > 100) width = 100;
+        inst->param_stereo_width = width;
+        post_param(inst, PARAM_EVENT_WIDTH, 0, GetStereoWidth(width), 0.0f);
+        return;
+    }
+    case PARAM_DIVISION: {
+        int div = (int)v;
+        if (div < 0) div = 0;
+        if (div >= DIV_COUNT) div = DIV_COUNT - 1;
+        inst->param_division = div;
+        refresh_synced_times(inst);
+        post_param(inst, PARAM_EVENT_DIVISION, 0, (float)div, 0.0f);
+        return;
+    }
+    case PARAM_QUALITY: {
+        int mode = (int)v;
+        if (mode < 0) mode = 0;
+        if (mode >= INTERP_COUNT) mode = INTERP_COUNT - 1;
+        inst->param_quality = mode;
+        post_param(inst, PARAM_EVENT_QUALITY, 0, (float)mode, 0.0f);
+        return;
+    }
+    case PARAM_TIME_MODE: {
+        int mode = (int)v;
+        if (mode < 0) mode = 0;
+        if (mode >= TIME_MODE_COUNT) mode = TIME_MODE_COUNT - 1;
+        inst->param_time_mode = mode;
+        post_param(inst, PARAM_EVENT_TIME_MODE, 0, (float)mode, 0.0f);
+        return;
+    }
+    case PARAM_OVERSAMPLING: {
+        int os = (int)v;
+        if (os < 0) os = 0;
+        if (os >= OVERSAMPLING_COUNT) os = OVERSAMPLING_COUNT - 1;
+        inst->param_oversampling = os;
+        post_param(inst, PARAM_EVENT_OVERSAMPLING, 0, (float)os, 0.0f);
+        return;
+    }
+    case PARAM_TAPS: {
+        int taps = (int)v;
+        if (taps < 0) taps = 0;
+        if (taps > MAX_TAPS) taps = MAX_TAPS;
+        inst->param_taps = taps;
+        post_param(inst, PARAM_EVENT_TAPS, 0, (float)taps, 0.0f);
+        return;
+    }
+    case PARAM_FREEZE: {
+        int mode = (int)v;
+        if (mode < 0) mode = 0;
+        if (mode >= FREEZE_COUNT) mode = FREEZE_COUNT - 1;
+        inst->param_freeze = mode;
+        post_param(inst, PARAM_EVENT_FREEZE, 0, (float)mode, 0.0f);
+        return;
+    }
+    case PARAM_PLAYBACK: {
+        int mode = (int)v;
+        if (mode < 0) mode = 0;
+        if (mode >= PLAYBACK_COUNT) mode = PLAYBACK_COUNT - 1;
+        inst->param_playback = mode;
+        post_param(inst, PARAM_EVENT_PLAYBACK, 0, (float)mode, 0.0f);
+        return;
+    }
+    }
+
+    if (v < 0.0f) v = 0.0f;
+    if (v > 1.0f) v = 1.0f;
+
+    switch (id) {
+    case PARAM_FEEDBACK:
+        inst->param_feedback = v;
+        post_param(inst, PARAM_EVENT_FEEDBACK, 0, GetFeedback(v, inst->param_drive), 0.0f);
+        break;
+    case PARAM_DRIVE:
+        inst->param_drive = v;
+        post_param(inst, PARAM_EVENT_DRIVE, 0, GetDriveGain(v), 0.0f);
+        post_param(inst, PARAM_EVENT_FEEDBACK, 0, GetFeedback(inst->param_feedback, v), 0.0f);
+        break;
+    case PARAM_MIX:
+        inst->param_mix = v;
+        post_param(inst, PARAM_EVENT_MIX, 0, v, 0.0f);
+        break;
+    case PARAM_TONE:
+        inst->param_tone = v;
+        apply_tone(inst);
+        break;
+    case PARAM_FLUTTER:
+        inst->param_flutter = v;
+        post_param(inst, PARAM_EVENT_MODULATION, 0, inst->param_flutter, inst->param_wow);
+        break;
+    case PARAM_WOW:
+        inst->param_wow = v;
+        post_param(inst, PARAM_EVENT_MODULATION, 0, inst->param_flutter, inst->param_wow);
+        break;
+    case PARAM_DUCKING:
+        inst->param_ducking = v;
+        post_param(inst, PARAM_EVENT_DUCKING, 0, v, 0.0f);
+        break;
     }
 }
 
+/* Apply restored fields in ID order, so taps land before their per-tap fields
+ * and each division after the time it overrides */
+static void state_apply(spacecho_instance_t *inst, const StateFields *st) {
+    for (int id = 0; id < PARAM_SETTABLE_COUNT; id++) {
+        if (!param_in_state(id) || !StateFields_Has(st, id)) continue;
+        if (id >= PARAM_TAP_FIRST && (id - PARAM_TAP_FIRST) / TAP_FIELD_COUNT >= inst->param_taps) break;
+
+        if (param_is_division(id)) {
+            int div = (int)st->value[id];
+            if (div < 0) div = 0;
+            if (div >= DIV_COUNT) div = DIV_COUNT - 1;
+            if (id == PARAM_DIVISION) inst->param_division = div;
+            else inst->taps[(id - PARAM_TAP_FIRST) / TAP_FIELD_COUNT].param_division = div;
+        } else {
+            set_param_number(inst, id, st->value[id]);
+        }
+    }
+    if (StateFields_Has(st, PARAM_BPM)) {
+        float bpm = st->value[PARAM_BPM];
+        if (bpm < 40.0f) bpm = 40.0f;
+        if (bpm > 300.0f) bpm = 300.0f;
+        inst->param_bpm = bpm;
+    }
+    /* Send the restored tempo and divisions; the audio thread retimes the synced heads */
+    refresh_synced_times(inst);
+    post_param(inst, PARAM_EVENT_BPM, 0, inst->param_bpm, 0.0f);
+    post_param(inst, PARAM_EVENT_DIVISION, 0, (float)inst->param_division, 0.0f);
+    for (int t = 0; t < MAX_TAPS; t++) {
+        post_param(inst, PARAM_EVENT_TAP_DIVISION, t, (float)inst->taps[t].param_division, 0.0f);
+    }
+}
+
+static int state_write_blob(const spacecho_instance_t *inst, char *buf, int buf_len) {
+    StateBlob blob;
+    memset(&blob, 0, sizeof(blob));
+    blob.magic = STATE_BLOB_MAGIC;
+    blob.version = STATE_BLOB_VERSION;
+    blob.size = sizeof(StateBlob);
+    blob.feedback = inst->param_feedback;
+    blob.mix = inst->param_mix;
+    blob.tone = inst->param_tone;
+    blob.flutter = inst->param_flutter;
+    blob.wow = inst->param_wow;
+    blob.time = (int16_t)inst->param_time;
+    blob.stereo_width = (int16_t)inst->param_stereo_width;
+    blob.bpm = (int16_t)(inst->param_bpm + 0.5f);
+    blob.bpm_exact = inst->param_bpm;
+    blob.time_mode = (uint8_t)inst->param_time_mode;
+    blob.drive = inst->param_drive;
+    blob.oversampling = (uint8_t)inst->param_oversampling;
+    blob.playback = (uint8_t)inst->param_playback;
+    blob.ducking = inst->param_ducking;
+    blob.division = (uint8_t)inst->param_division;
+    blob.quality = (uint8_t)inst->param_quality;
+    blob.taps = (uint8_t)inst->param_taps;
+    for (int t = 0; t < inst->param_taps; t++) {
+        blob.tap[t].time = (int16_t)inst->taps[t].param_time;
+        blob.tap[t].division = (uint8_t)inst->taps[t].param_division;
+        blob.tap[t].gain = inst->taps[t].param_gain;
+        blob.tap[t].pan = inst->taps[t].param_pan;
+    }
+    return base64_encode((const uint8_t *)&blob, sizeof(blob), buf, buf_len);
+}
+
 /* ============================================================================
  * MIDI CLOCK - BPM detection from 0xF8 timing messages
  * ============================================================================ */
 
-static void spacecho_on_midi(void *instance, const uint8_t *msg, int len, int source) {
+#define TEMPO_DEADBAND_BPM 0.05f  /* ignore fit noise below this */
+
+/* frame_offset: position of the message within the next block (0 if unknown) */
+static void spacecho_on_midi_at(void *instance, const uint8_t *msg, int len, int source, int frame_offset) {
     spacecho_instance_t *inst = (spacecho_instance_t*)instance;
     if (!inst || len < 1) return;
     (void)source;
@@ -441,40 +5115,27 @@ static void spacecho_on_midi(void *instance, const uint8_t *msg, int len, int so
     uint8_t status = msg[0];
 
     if (status == 0xF8) {
-        /* Timing clock tick - 24 per quarter note.
-         * MIDI clock is quantized to audio block boundaries (128 samples),
-         * so individual tick intervals jitter by ~3ms. We accumulate samples
-         * over a full quarter note (24 ticks) for one stable measurement,
-         * then lock the BPM and only update on significant tempo changes. */
-        inst->clock_tick_count++;
-
-        if (inst->clock_tick_count >= CLOCKS_PER_QUARTER) {
-            /* One full quarter note elapsed - measure BPM */
-            int total_samples = inst->clock_sample_counter;
-            float bpm = (SAMPLE_RATE * 60.0f) / (float)total_samples;
-            int bpm_int = (int)(bpm + 0.5f);
-            if (bpm_int < 40) bpm_int = 40;
-            if (bpm_int > 300) bpm_int = 300;
-
-            /* Only update if BPM changed significantly (>=3 BPM) */
-            if (!inst->clock_running || abs(bpm_int - inst->param_bpm) >= 3) {
-                inst->param_bpm = bpm_int;
+        /* Timing clock tick - 24 per quarter note. Ticks are stamped at their
+         * sample position and fitted over a sliding window; the synced times
+         * follow every tick once the estimate moves past the deadband. */
+        float bpm;
+        if (frame_offset < 0) frame_offset = 0;
+        if (TempoTracker_Tick(&inst->tempo, inst->clock_sample_pos + frame_offset, inst->sampleRate, &bpm)) {
+            if (bpm < 40.0f) bpm = 40.0f;
+            if (bpm > 300.0f) bpm = 300.0f;
+            if (!inst->clock_running || fabsf(bpm - inst->clock_bpm) >= TEMPO_DEADBAND_BPM) {
+                inst->clock_bpm = bpm;
                 inst->clock_running = 1;
-                /* Recompute synced delay time */
-                if (inst->param_division != DIV_FREE) {
-                    apply_synced_time(inst);
-                }
+                /* The kernel retimes the synced heads at its next block, after
+                 * the queued set_param changes; get_param picks it up too */
+                atomic_store_explicit(&inst->clockTempo, clock_tempo_pack(++inst->clock_seq, bpm),
+                                      memory_order_release);
             }
-
-            /* Reset for next quarter note measurement */
-            inst->clock_tick_count = 0;
-            inst->clock_sample_counter = 0;
         }
     }
     else if (status == 0xFA) {
         /* Start */
-        inst->clock_tick_count = 0;
-        inst->clock_sample_counter = 0;
+        TempoTracker_Reset(&inst->tempo);
         inst->clock_running = 1;
     }
     else if (status == 0xFC) {
@@ -482,189 +5143,136 @@ static void spacecho_on_midi(void *instance, const uint8_t *msg, int len, int so
         inst->clock_running = 0;
     }
     else if (status == 0xFB) {
-        /* Continue */
+        /* Continue - the gap since Stop would skew the fit */
+        TempoTracker_Reset(&inst->tempo);
         inst->clock_running = 1;
     }
 }
 
-/* Helper to extract a JSON number value by key */
-static int json_get_number(const char *json, const char *key, float *out) {
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    const char *pos = strstr(json, search);
-    if (!pos) return -1;
-    pos += strlen(search);
-    while (*pos == ' ') pos++;
-    *out = (float)atof(pos);
-    return 0;
-}
-
-/* Helper to extract a JSON string value by key */
-static int json_get_string(const char *json, const char *key, char *out, int out_len) {
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    const char *pos = strstr(json, search);
-    if (!pos) return -1;
-    pos += strlen(search);
-    while (*pos == ' ') pos++;
-    if (*pos != '"') return -1;
-    pos++;
-    int i = 0;
-    while (*pos && *pos != '"' && i < out_len - 1) {
-        out[i++] = *pos++;
-    }
-    out[i] = '\0';
-    return 0;
+static void spacecho_on_midi(void *instance, const uint8_t *msg, int len, int source) {
+    spacecho_on_midi_at(instance, msg, len, source, 0);
 }
 
 static void v2_set_param(void *instance, const char *key, const char *val) {
     spacecho_instance_t *inst = (spacecho_instance_t*)instance;
     if (!inst) return;
+    pull_clock_tempo(inst);
 
-    /* State restore from patch save */
-    if (strcmp(key, "state") == 0) {
-        float v;
-        if (json_get_number(val, "time", &v) == 0) {
-            int ms = (int)v;
-            if (ms < 20) ms = 20;
-            if (ms > 2000) ms = 2000;
-            inst->param_time = ms;
-            SmoothedValue_SetTarget(&inst->smoothedDelayTime, GetDelayTimeSeconds(ms), RAMP_SAMPLES);
-        }
-        if (json_get_number(val, "feedback", &v) == 0) {
-            inst->param_feedback = v;
-            SmoothedValue_SetTarget(&inst->smoothedFeedback, GetFeedback(v), RAMP_SAMPLES);
-        }
-        if (json_get_number(val, "mix", &v) == 0) {
-            inst->param_mix = v;
-            SmoothedValue_SetTarget(&inst->smoothedMix, v, RAMP_SAMPLES);
-        }
-        if (json_get_number(val, "tone", &v) == 0) {
-            inst->param_tone = v;
-            for (int ch = 0; ch < MAX_CHANNELS; ch++) {
-                OnePoleFilter_SetCutoff(&inst->toneFilter[ch], GetToneFrequency(v), SAMPLE_RATE);
-            }
-        }
-        if (json_get_number(val, "stereo_width", &v) == 0) {
-            int width = (int)v;
-            if (width < 0) width = 0;
-            if (width > 100) width = 100;
-            inst->param_stereo_width = width;
-            SmoothedValue_SetTarget(&inst->smoothedStereoWidth, GetStereoWidth(width), RAMP_SAMPLES);
-        }
-        {
-            char div_str[16];
-            if (json_get_string(val, "division", div_str, sizeof(div_str)) == 0) {
-                inst->param_division = parse_division(div_str);
-            }
-        }
-        if (json_get_number(val, "bpm", &v) == 0) {
-            int bpm = (int)v;
-            if (bpm < 40) bpm = 40;
-            if (bpm > 300) bpm = 300;
-            inst->param_bpm = bpm;
-        }
-        /* If division is active, recompute time from restored bpm/division */
-        if (inst->param_division != DIV_FREE) {
-            apply_synced_time(inst);
-        }
-        return;
-    }
-
-    if (strcmp(key, "time") == 0) {
-        int ms = atoi(val);
-        if (ms < 20) ms = 20;
-        if (ms > 2000) ms = 2000;
-        inst->param_time = ms;
-        inst->param_division = DIV_FREE; /* manual override reverts sync */
-        SmoothedValue_SetTarget(&inst->smoothedDelayTime, GetDelayTimeSeconds(ms), RAMP_SAMPLES);
-        return;
-    }
-
-    if (strcmp(key, "stereo_width") == 0 || strcmp(key, "width") == 0) {
-        int width = atoi(val);
-        if (width < 0) width = 0;
-        if (width > 100) width = 100;
-        inst->param_stereo_width = width;
-        SmoothedValue_SetTarget(&inst->smoothedStereoWidth, GetStereoWidth(width), RAMP_SAMPLES);
-        return;
-    }
+    int id = param_key_id(key);
+    if (id < 0) return;
 
-    if (strcmp(key, "division") == 0) {
-        inst->param_division = parse_division(val);
-        if (inst->param_division != DIV_FREE) {
-            apply_synced_time(inst);
+    /* State restore from patch save: JSON object or base64 blob */
+    if (id == PARAM_STATE || id == PARAM_STATE_BLOB) {
+        StateFields st;
+        int rc = (*json_skip_ws(val) == '{') ? state_parse_json(val, &st) : state_parse_blob(val, &st);
+        if (rc != 0) {
+            plugin_log("state restore: malformed state ignored");
+            return;
         }
+        state_apply(inst, &st);
         return;
     }
 
-    float v = atof(val);
-    if (v < 0.0f) v = 0.0f;
-    if (v > 1.0f) v = 1.0f;
+    if (id >= PARAM_SETTABLE_COUNT) return;
 
-    if (0) {
-        /* placeholder - time handled above */
-    }
-    else if (strcmp(key, "feedback") == 0) {
-        inst->param_feedback = v;
-        SmoothedValue_SetTarget(&inst->smoothedFeedback, GetFeedback(v), RAMP_SAMPLES);
-    }
-    else if (strcmp(key, "mix") == 0) {
-        inst->param_mix = v;
-        SmoothedValue_SetTarget(&inst->smoothedMix, v, RAMP_SAMPLES);
-    }
-    else if (strcmp(key, "tone") == 0) {
-        inst->param_tone = v;
-        for (int ch = 0; ch < MAX_CHANNELS; ch++) {
-            OnePoleFilter_SetCutoff(&inst->toneFilter[ch], GetToneFrequency(v), SAMPLE_RATE);
-        }
-    }
+    /* Enum params accept labels or an index; everything else is numeric */
+    int count;
+    const char *const *names = param_options(id, &count);
+    set_param_number(inst, id, names ? (float)parse_option(val, names, count) : (float)atof(val));
 }
 
 static int v2_get_param(void *instance, const char *key, char *buf, int buf_len) {
     spacecho_instance_t *inst = (spacecho_instance_t*)instance;
     if (!inst) return -1;
+    pull_clock_tempo(inst);
 
-    if (strcmp(key, "time") == 0) {
-        return snprintf(buf, buf_len, "%d", inst->param_time);
+    int id = param_key_id(key);
+    if (id >= PARAM_TAP_FIRST && id <= PARAM_TAP_LAST) {
+        return get_tap_param(inst, (id - PARAM_TAP_FIRST) / TAP_FIELD_COUNT,
+                             (id - PARAM_TAP_FIRST) % TAP_FIELD_COUNT, buf, buf_len);
     }
-    else if (strcmp(key, "feedback") == 0) {
+
+    switch (id) {
+    case PARAM_TIME:
+        return snprintf(buf, buf_len, "%d", inst->param_time);
+    case PARAM_FEEDBACK:
         return snprintf(buf, buf_len, "%.2f", inst->param_feedback);
-    }
-    else if (strcmp(key, "mix") == 0) {
+    case PARAM_DRIVE:
+        return snprintf(buf, buf_len, "%.2f", inst->param_drive);
+    case PARAM_OVERSAMPLING:
+        return snprintf(buf, buf_len, "%s", oversampling_names[inst->param_oversampling]);
+    case PARAM_MIX:
         return snprintf(buf, buf_len, "%.2f", inst->param_mix);
-    }
-    else if (strcmp(key, "tone") == 0) {
+    case PARAM_TONE:
         return snprintf(buf, buf_len, "%.2f", inst->param_tone);
-    }
-    else if (strcmp(key, "stereo_width") == 0 || strcmp(key, "width") == 0) {
+    case PARAM_STEREO_WIDTH:
         return snprintf(buf, buf_len, "%d", inst->param_stereo_width);
-    }
-    else if (strcmp(key, "division") == 0) {
+    case PARAM_FLUTTER:
+        return snprintf(buf, buf_len, "%.2f", inst->param_flutter);
+    case PARAM_WOW:
+        return snprintf(buf, buf_len, "%.2f", inst->param_wow);
+    case PARAM_DUCKING:
+        return snprintf(buf, buf_len, "%.2f", inst->param_ducking);
+    case PARAM_DIVISION:
         return snprintf(buf, buf_len, "%s", division_names[inst->param_division]);
-    }
-    else if (strcmp(key, "bpm") == 0) {
-        return snprintf(buf, buf_len, "%d", inst->param_bpm);
-    }
-    else if (strcmp(key, "name") == 0) {
+    case PARAM_BPM:
+        return snprintf(buf, buf_len, "%.2f", inst->param_bpm);
+    case PARAM_NAME:
         return snprintf(buf, buf_len, "TapeDelay");
-    }
-    else if (strcmp(key, "state") == 0) {
-        return snprintf(buf, buf_len,
-            "{\"time\":%d,\"feedback\":%.4f,\"mix\":%.4f,\"tone\":%.4f,\"stereo_width\":%d,\"division\":\"%s\",\"bpm\":%d}",
+    case PARAM_TAPS:
+        return snprintf(buf, buf_len, "%d", inst->param_taps);
+    case PARAM_QUALITY:
+        return snprintf(buf, buf_len, "%s", interp_names[inst->param_quality]);
+    case PARAM_TIME_MODE:
+        return snprintf(buf, buf_len, "%s", time_mode_names[inst->param_time_mode]);
+    case PARAM_FREEZE:
+        return snprintf(buf, buf_len, "%s", freeze_names[inst->param_freeze]);
+    case PARAM_PLAYBACK:
+        return snprintf(buf, buf_len, "%s", playback_names[inst->param_playback]);
+    case PARAM_STATE: {
+        int len = snprintf(buf, buf_len,
+            "{\"time\":%d,\"feedback\":%.4f,\"mix\":%.4f,\"tone\":%.4f,\"flutter\":%.4f,\"wow\":%.4f,\"stereo_width\":%d,\"division\":\"%s\",\"bpm\":%.2f,\"quality\":\"%s\",\"time_mode\":\"%s\",\"drive\":%.4f,\"oversampling\":\"%s\",\"playback\":\"%s\",\"ducking\":%.4f,\"taps\":%d",
             inst->param_time, inst->param_feedback, inst->param_mix, inst->param_tone,
-            inst->param_stereo_width, division_names[inst->param_division], inst->param_bpm);
+            inst->param_flutter, inst->param_wow, inst->param_stereo_width, division_names[inst->param_division], inst->param_bpm,
+            interp_names[inst->param_quality], time_mode_names[inst->param_time_mode], inst->param_drive,
+            oversampling_names[inst->param_oversampling], playback_names[inst->param_playback], inst->param_ducking,
+            inst->param_taps);
+        /* Only active taps are saved */
+        for (int t = 0; t < inst->param_taps && len < buf_len; t++) {
+            const DelayTap *tap = &inst->taps[t];
+            len += snprintf(buf + len, buf_len - len,
+                ",\"tap%d_time\":%d,\"tap%d_division\":\"%s\",\"tap%d_gain\":%.4f,\"tap%d_pan\":%.4f",
+                t + 1, tap->param_time, t + 1, division_names[tap->param_division],
+                t + 1, tap->param_gain, t + 1, tap->param_pan);
+        }
+        if (len < buf_len) len += snprintf(buf + len, buf_len - len, "}");
+        return len < buf_len ? len : -1;
     }
 
+    case PARAM_STATE_BLOB:
+        return state_write_blob(inst, buf, buf_len);
+
+    /* Added output latency in frames (one host block while offloaded) */
+    case PARAM_LATENCY:
+        return snprintf(buf, buf_len, "%d", inst->worker.running ? inst->worker.capacity : 0);
+
+    /* Hot-path timing and event counters (SPACECHO_PERF_STATS builds) */
+    case PARAM_PERF_STATS:
+#ifdef SPACECHO_PERF_STATS
+        return PerfStats_Write(&inst->perf, inst->sampleRate, inst->worker.xruns, buf, buf_len);
+#else
+        return snprintf(buf, buf_len, "{\"enabled\":false}");
+#endif
+
     /* UI hierarchy for shadow parameter editor */
-    if (strcmp(key, "ui_hierarchy") == 0) {
+    case PARAM_UI_HIERARCHY: {
         const char *hierarchy = "{"
             "\"modes\":null,"
             "\"levels\":{"
                 "\"root\":{"
                     "\"children\":null,"
                     "\"knobs\":[\"time\",\"division\",\"feedback\",\"mix\",\"tone\",\"stereo_width\"],"
-                    "\"params\":[\"time\",\"division\",\"feedback\",\"mix\",\"tone\",\"stereo_width\"]"
+                    "\"params\":[\"time\",\"division\",\"feedback\",\"mix\",\"tone\",\"flutter\",\"wow\",\"stereo_width\",\"quality\",\"time_mode\",\"drive\",\"oversampling\",\"taps\",\"freeze\",\"playback\",\"ducking\"]"
                 "}"
             "}"
         "}";
@@ -677,21 +5285,40 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
     }
 
     /* Chain params metadata for shadow parameter editor */
-    if (strcmp(key, "chain_params") == 0) {
+    case PARAM_CHAIN_PARAMS: {
         const char *params_json = "["
             "{\"key\":\"time\",\"name\":\"Time\",\"type\":\"int\",\"min\":20,\"max\":2000,\"step\":1},"
-            "{\"key\":\"division\",\"name\":\"Division\",\"type\":\"enum\",\"options\":[\"free\",\"1/1\",\"1/2\",\"1/2d\",\"1/4\",\"1/4d\",\"1/4t\",\"1/8\",\"1/8d\",\"1/8t\",\"1/16\",\"1/16t\"],\"default\":0},"
+            "{\"key\":\"division\",\"name\":\"Division\",\"type\":\"enum\",\"options\":" DIVISION_OPTIONS_JSON ",\"default\":0},"
             "{\"key\":\"feedback\",\"name\":\"Feedback\",\"type\":\"float\",\"min\":0,\"max\":1,\"step\":0.01},"
             "{\"key\":\"mix\",\"name\":\"Mix\",\"type\":\"float\",\"min\":0,\"max\":1,\"step\":0.01},"
             "{\"key\":\"tone\",\"name\":\"Tone\",\"type\":\"float\",\"min\":0,\"max\":1,\"step\":0.01},"
-            "{\"key\":\"stereo_width\",\"name\":\"Stereo Width\",\"type\":\"int\",\"min\":0,\"max\":100,\"step\":1}"
-        "]";
+            "{\"key\":\"flutter\",\"name\":\"Flutter\",\"type\":\"float\",\"min\":0,\"max\":1,\"step\":0.01},"
+            "{\"key\":\"wow\",\"name\":\"Wow\",\"type\":\"float\",\"min\":0,\"max\":1,\"step\":0.01},"
+            "{\"key\":\"stereo_width\",\"name\":\"Stereo Width\",\"type\":\"int\",\"min\":0,\"max\":100,\"step\":1},"
+            "{\"key\":\"quality\",\"name\":\"Quality\",\"type\":\"enum\",\"options\":" QUALITY_OPTIONS_JSON ",\"default\":0},"
+            "{\"key\":\"time_mode\",\"name\":\"Time Mode\",\"type\":\"enum\",\"options\":" TIME_MODE_OPTIONS_JSON ",\"default\":0},"
+            "{\"key\":\"drive\",\"name\":\"Drive\",\"type\":\"float\",\"min\":0,\"max\":1,\"step\":0.01},"
+            "{\"key\":\"oversampling\",\"name\":\"Oversampling\",\"type\":\"enum\",\"options\":" OVERSAMPLING_OPTIONS_JSON ",\"default\":0},"
+            "{\"key\":\"taps\",\"name\":\"Taps\",\"type\":\"int\",\"min\":0,\"max\":8,\"step\":1},"
+            "{\"key\":\"freeze\",\"name\":\"Freeze\",\"type\":\"enum\",\"options\":" FREEZE_OPTIONS_JSON ",\"default\":0},"
+            "{\"key\":\"playback\",\"name\":\"Playback\",\"type\":\"enum\",\"options\":" PLAYBACK_OPTIONS_JSON ",\"default\":0},"
+            "{\"key\":\"ducking\",\"name\":\"Ducking\",\"type\":\"float\",\"min\":0,\"max\":1,\"step\":0.01}";
         int len = strlen(params_json);
-        if (len < buf_len) {
-            strcpy(buf, params_json);
-            return len;
+        if (len >= buf_len) return -1;
+        strcpy(buf, params_json);
+
+        /* Per-tap entries: tap1_time .. tap8_pan */
+        for (int t = 1; t <= MAX_TAPS && len < buf_len; t++) {
+            len += snprintf(buf + len, buf_len - len,
+                ",{\"key\":\"tap%d_time\",\"name\":\"Tap %d Time\",\"type\":\"int\",\"min\":20,\"max\":2000,\"step\":1}"
+                ",{\"key\":\"tap%d_division\",\"name\":\"Tap %d Division\",\"type\":\"enum\",\"options\":" DIVISION_OPTIONS_JSON ",\"default\":0}"
+                ",{\"key\":\"tap%d_gain\",\"name\":\"Tap %d Gain\",\"type\":\"float\",\"min\":0,\"max\":1,\"step\":0.01}"
+                ",{\"key\":\"tap%d_pan\",\"name\":\"Tap %d Pan\",\"type\":\"float\",\"min\":-1,\"max\":1,\"step\":0.01}",
+                t, t, t, t, t, t, t, t);
         }
-        return -1;
+        if (len < buf_len) len += snprintf(buf + len, buf_len - len, "]");
+        return len < buf_len ? len : -1;
+    }
     }
 
     return -1;
@@ -701,12 +5328,17 @@ static audio_fx_api_v2_t g_fx_api_v2;
 
 audio_fx_api_v2_t* move_audio_fx_init_v2(const host_api_v1_t *host) {
     g_host = host;
+    param_keys_init();
 
     memset(&g_fx_api_v2, 0, sizeof(g_fx_api_v2));
     g_fx_api_v2.api_version = AUDIO_FX_API_VERSION_2;
     g_fx_api_v2.create_instance = v2_create_instance;
     g_fx_api_v2.destroy_instance = v2_destroy_instance;
+#ifdef SPACECHO_REFERENCE_KERNEL
+    g_fx_api_v2.process_block = v2_process_block_reference;
+#else
     g_fx_api_v2.process_block = v2_process_block;
+#endif
     g_fx_api_v2.set_param = v2_set_param;
     g_fx_api_v2.get_param = v2_get_param;
 
@@ -722,3 +5354,89 @@ audio_fx_api_v2_t* move_audio_fx_init_v2(const host_api_v1_t *host) {
 void move_audio_fx_on_midi(void *instance, const uint8_t *msg, int len, int source) {
     spacecho_on_midi(instance, msg, len, source);
 }
+
+/*
+ * Sample-accurate variant - frame_offset is the message's position within
+ * the next process_block call, so clock ticks are stamped exactly.
+ */
+void move_audio_fx_on_midi_at(void *instance, const uint8_t *msg, int len, int source, int frame_offset) {
+    spacecho_on_midi_at(instance, msg, len, source, frame_offset);
+}
+
+/*
+ * Batch export - chain host discovers this via dlsym. Processes count
+ * instances (each with its own interleaved stereo buffer) over the same
+ * block; equivalent to calling process_block on each in turn. Instances
+ * must be distinct.
+ */
+void move_audio_fx_process_batch(void *const *instances, int16_t *const *audio_inout, int count, int frames) {
+    if (!instances || !audio_inout || frames <= 0) return;
+    uint64_t fpMode = ftz_enter();
+    for (int first = 0; first < count; first += BATCH_MAX) {
+        int group = count - first < BATCH_MAX ? count - first : BATCH_MAX;
+#ifdef SPACECHO_REFERENCE_KERNEL
+        for (int k = 0; k < group; k++) {
+            v2_process_block_reference(instances[first + k], audio_inout[first + k], frames);
+        }
+#else
+        process_batch((spacecho_instance_t *const *)(instances + first), audio_inout + first, group, frames);
+#endif
+    }
+    ftz_leave(fpMode);
+}
+
+/*
+ * Float export - chain host discovers this via dlsym. Processes one block in
+ * place as 32-bit floats (full scale +-1.0) with no int16 conversion or
+ * clamping, so a chain can stay in float across stages. Frame i of each
+ * channel is at left[i * stride] and right[i * stride]: planar buffers pass
+ * stride 1, an interleaved buffer passes (buf, buf + 1, 2). Offloaded
+ * instances (and the reference kernel build) still round-trip through int16.
+ */
+void move_audio_fx_process_block_f32(void *instance, float *left, float *right, int stride, int frames) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)instance;
+    if (!inst || !inst->initialized || !left || !right || stride < 1 || frames <= 0) return;
+#ifndef SPACECHO_REFERENCE_KERNEL
+    if (!inst->worker.running) {
+        inst->clock_sample_pos += frames;
+        uint64_t fpMode = ftz_enter();
+        kernel_run_f32(inst, left, right, stride, frames);
+        ftz_leave(fpMode);
+        return;
+    }
+#endif
+    for (int offset = 0; offset < frames; offset += inst->bridgeFrames) {
+        int n = frames - offset;
+        if (n > inst->bridgeFrames) n = inst->bridgeFrames;
+        float *l = left + (size_t)offset * stride, *r = right + (size_t)offset * stride;
+        for (int i = 0; i < n; i++) {
+            inst->bridge[i * 2] = (int16_t)(fminf(fmaxf(l[i * stride], -1.0f), 1.0f) * 32767.0f);
+            inst->bridge[i * 2 + 1] = (int16_t)(fminf(fmaxf(r[i * stride], -1.0f), 1.0f) * 32767.0f);
+        }
+        g_fx_api_v2.process_block(inst, inst->bridge, n);
+        for (int i = 0; i < n; i++) {
+            l[i * stride] = inst->bridge[i * 2] / 32768.0f;
+            r[i * stride] = inst->bridge[i * 2 + 1] / 32768.0f;
+        }
+    }
+}
+
+/*
+ * Numeric parameter exports - chain host discovers these via dlsym.
+ * Resolve each key to an ID once, then set the value by ID with no string
+ * parsing. Enum params (division, quality, tapN_division) take their option
+ * index. Returns -1 for unknown keys / non-settable IDs.
+ */
+int move_audio_fx_param_id(const char *key) {
+    param_keys_init();
+    int id = key ? param_key_id(key) : -1;
+    return id < PARAM_SETTABLE_COUNT ? id : -1;
+}
+
+int move_audio_fx_set_param_id(void *instance, int id, float value) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)instance;
+    if (!inst || id < 0 || id >= PARAM_SETTABLE_COUNT) return -1;
+    pull_clock_tempo(inst);
+    set_param_number(inst, id, value);
+    return 0;
+}
@@ -0,0 +1,344 @@
+/*
+ * Offline benchmark for the DSP core.
+ *
+ * Sweeps input signal, parameter change pattern, block size and instance
+ * count over instances created through move_audio_fx_init_v2, and reports
+ * per configuration:
+ *   ns/frame, cycles/frame  whole process_block, per frame per instance
+ *   load%                   share of the real-time budget for all instances
+ *   front/tone/back         ns/frame of the three kernel chunk stages
+ *                           (timed in a second, instrumented pass)
+ *
+ * Cycles come from the Linux perf cycle counter when the kernel allows it,
+ * the TSC on x86 otherwise, and print as "-" when neither is available.
+ *
+ * A second table follows one impulse through a long decay tail with the
+ * states most prone to sticking in subnormal range (slowest tone filter,
+ * allpass interpolation), for the reference and block kernels, and prints
+ * ns/frame per half second: with denormal protection working it stays flat.
+ *
+ * Build and run with scripts/bench.sh (native, or CROSS_PREFIX for the Move).
+ * Usage: spacecho_bench [seconds per configuration, default 2]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/dsp/spacecho.c"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define BENCH_MAX_INSTANCES 8
+#define BENCH_SAMPLE_RATE 44100
+
+static void bench_log(const char *msg) {
+    (void)msg;
+}
+
+/* ---- Timers -------------------------------------------------------------- */
+
+static int g_perf_fd = -1;
+static const char *g_cycle_source = "none";
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void cycles_init(void) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    g_perf_fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    if (g_perf_fd >= 0) {
+        ioctl(g_perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+        g_cycle_source = "perf";
+        return;
+    }
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    g_cycle_source = "tsc";
+#endif
+}
+
+/* Monotonic cycle count, 0 when unavailable */
+static uint64_t now_cycles(void) {
+#ifdef __linux__
+    if (g_perf_fd >= 0) {
+        uint64_t count = 0;
+        if (read(g_perf_fd, &count, sizeof(count)) == (ssize_t)sizeof(count)) return count;
+        return 0;
+    }
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* ---- Signals and change patterns ------------------------------------------ */
+
+typedef enum { SIGNAL_SILENCE, SIGNAL_NOISE, SIGNAL_IMPULSE, SIGNAL_COUNT } Signal;
+typedef enum { PATTERN_STATIC, PATTERN_TIME_RAMP, PATTERN_DIVISION, PATTERN_COUNT } Pattern;
+
+static const char *signal_names[SIGNAL_COUNT] = { "silence", "noise", "impulse" };
+static const char *pattern_names[PATTERN_COUNT] = { "static", "time_ramp", "division" };
+
+static uint32_t rng_state = 1u;
+
+static int16_t noise_sample(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (int16_t)((int32_t)(rng_state >> 16) - 32768) / 4;
+}
+
+/* Fill one instance's block; impulses land once per second */
+static void fill_block(int16_t *audio, int frames, Signal signal, int64_t position) {
+    if (signal == SIGNAL_NOISE) {
+        for (int i = 0; i < frames * 2; i++) audio[i] = noise_sample();
+        return;
+    }
+    memset(audio, 0, (size_t)frames * 2 * sizeof(int16_t));
+    if (signal == SIGNAL_IMPULSE) {
+        int64_t next = (position + BENCH_SAMPLE_RATE - 1) / BENCH_SAMPLE_RATE * BENCH_SAMPLE_RATE;
+        if (next < position + frames) {
+            audio[(next - position) * 2] = 30000;
+            audio[(next - position) * 2 + 1] = 30000;
+        }
+    }
+}
+
+static void configure(audio_fx_api_v2_t *api, void *inst, Signal signal) {
+    api->set_param(inst, "feedback", signal == SIGNAL_IMPULSE ? "1.0" : "0.5");
+    api->set_param(inst, "mix", "0.5");
+    api->set_param(inst, "time", "400");
+}
+
+/* Parameter changes four times a second */
+static void apply_pattern(audio_fx_api_v2_t *api, void *inst, Pattern pattern, int step) {
+    static const char *times[] = { "250", "600", "333", "1200" };
+    static const char *divisions[] = { "1/4", "1/8", "1/8d", "1/16", "1/4t" };
+    if (pattern == PATTERN_TIME_RAMP) {
+        api->set_param(inst, "time", times[step % 4]);
+    } else if (pattern == PATTERN_DIVISION) {
+        api->set_param(inst, "division", divisions[step % 5]);
+    }
+}
+
+/* ---- Runs ------------------------------------------------------------------ */
+
+typedef struct {
+    uint64_t ns;
+    uint64_t cycles;
+    uint64_t stage_ns[3];  /* front, tone, back */
+} BenchResult;
+
+/* One process_block call through the kernel stages, timing each */
+static void process_block_staged(spacecho_instance_t *inst, int16_t *audio, int frames, uint64_t *stage_ns) {
+    inst->clock_sample_pos += frames;
+    drain_param_queue(inst);
+    for (int offset = 0; offset < frames; offset += inst->chunkFrames) {
+        int n = frames - offset;
+        if (n > inst->chunkFrames) n = inst->chunkFrames;
+        KernelControl ctl;
+        uint64_t t0 = now_ns();
+        int live = kernel_chunk_front(inst, &ctl, audio + offset * 2, audio + offset * 2, n);
+        uint64_t t1 = now_ns();
+        stage_ns[0] += t1 - t0;
+        if (!live) continue;
+        kernel_tone(inst, &ctl, n);
+        uint64_t t2 = now_ns();
+        kernel_chunk_back(inst, &ctl, audio + offset * 2, audio + offset * 2, n);
+        uint64_t t3 = now_ns();
+        stage_ns[1] += t2 - t1;
+        stage_ns[2] += t3 - t2;
+    }
+}
+
+static void run(audio_fx_api_v2_t *api, Signal signal, Pattern pattern, int block, int count,
+                int64_t frames, int staged, BenchResult *result) {
+    void *insts[BENCH_MAX_INSTANCES];
+    int16_t *audio[BENCH_MAX_INSTANCES];
+    for (int k = 0; k < count; k++) {
+        insts[k] = api->create_instance(NULL, "{}");
+        audio[k] = malloc((size_t)block * 2 * sizeof(int16_t));
+        configure(api, insts[k], signal);
+    }
+    rng_state = 1u;
+    memset(result, 0, sizeof(*result));
+
+    /* Warm up caches and let the first ramps settle before timing */
+    const int64_t warmup = BENCH_SAMPLE_RATE / 5;
+    const int64_t change_every = BENCH_SAMPLE_RATE / 4;
+    int step = 0;
+    int64_t next_change = warmup;
+    for (int64_t pos = 0; pos < warmup + frames; pos += block) {
+        if (pos >= next_change) {
+            for (int k = 0; k < count; k++) apply_pattern(api, insts[k], pattern, step);
+            step++;
+            next_change += change_every;
+        }
+        for (int k = 0; k < count; k++) fill_block(audio[k], block, signal, pos);
+
+        uint64_t t0 = now_ns(), c0 = now_cycles();
+        for (int k = 0; k < count; k++) {
+            if (staged) process_block_staged((spacecho_instance_t *)insts[k], audio[k], block, result->stage_ns);
+            else api->process_block(insts[k], audio[k], block);
+        }
+        uint64_t t1 = now_ns(), c1 = now_cycles();
+        if (pos >= warmup) {
+            result->ns += t1 - t0;
+            result->cycles += c1 - c0;
+        } else if (staged) {
+            memset(result->stage_ns, 0, sizeof(result->stage_ns));
+        }
+    }
+
+    for (int k = 0; k < count; k++) {
+        api->destroy_instance(insts[k]);
+        free(audio[k]);
+    }
+}
+
+/* ---- Decay tail ------------------------------------------------------------ */
+
+#define DECAY_SECONDS 8
+#define DECAY_WINDOWS (DECAY_SECONDS * 2)
+
+static void run_decay(audio_fx_api_v2_t *api, int reference, double *window_ns, int *subnormal) {
+    const int block = 128;
+    const int64_t window_frames = BENCH_SAMPLE_RATE / 2;
+    spacecho_instance_t *inst = (spacecho_instance_t *)api->create_instance(NULL, "{}");
+    api->set_param(inst, "feedback", "0.5");
+    api->set_param(inst, "time", "20");
+    api->set_param(inst, "tone", "0.0");
+    api->set_param(inst, "quality", "allpass");
+    int16_t audio[128 * 2] = {0};
+    for (int k = 0; k < 100; k++) api->process_block(inst, audio, block);  /* settle the ramps */
+
+    int64_t pos = 0;
+    for (int w = 0; w < DECAY_WINDOWS; w++) {
+        uint64_t ns = 0;
+        for (; pos < (w + 1) * window_frames; pos += block) {
+            memset(audio, 0, sizeof(audio));
+            if (pos == 0) audio[0] = audio[1] = 30000;
+            uint64_t t0 = now_ns();
+            if (reference) v2_process_block_reference(inst, audio, block);
+            else api->process_block(inst, audio, block);
+            ns += now_ns() - t0;
+        }
+        window_ns[w] = (double)ns / (double)window_frames;
+        subnormal[w] = 0;
+        for (int ch = 0; ch < MAX_CHANNELS; ch++) {
+            subnormal[w] |= fpclassify(inst->toneFilter[ch].z1) == FP_SUBNORMAL ||
+                            fpclassify(inst->allpassState[ch]) == FP_SUBNORMAL;
+        }
+    }
+    api->destroy_instance(inst);
+}
+
+static void bench_decay(host_api_v1_t *host) {
+#ifdef SPACECHO_HAVE_FTZ
+    /* -Ofast startup code sets FZ for the whole process; clear it so the
+     * kernel sees an audio thread that does not flush */
+    ftz_write(ftz_read() & ~(uint64_t)FTZ_BITS);
+#endif
+    host->frames_per_block = 128;
+    audio_fx_api_v2_t *api = move_audio_fx_init_v2(host);
+    if (!api) return;
+
+    double ns[2][DECAY_WINDOWS];
+    int subnormal[2][DECAY_WINDOWS];
+    run_decay(api, 1, ns[0], subnormal[0]);
+    run_decay(api, 0, ns[1], subnormal[1]);
+
+    printf("\n# decay tail after one impulse (feedback 0.5, 20ms, darkest tone, allpass), "
+           "ns/frame per 0.5s; * = subnormal state\n");
+    printf("%6s %11s %11s\n", "t", "reference", "block");
+    double lo[2] = { 1e30, 1e30 }, hi[2] = { 0.0, 0.0 };
+    for (int w = 0; w < DECAY_WINDOWS; w++) {
+        printf("%5.1fs %10.2f%c %10.2f%c\n", 0.5 * (w + 1),
+               ns[0][w], subnormal[0][w] ? '*' : ' ', ns[1][w], subnormal[1][w] ? '*' : ' ');
+        for (int k = 0; k < 2; k++) {
+            if (ns[k][w] < lo[k]) lo[k] = ns[k][w];
+            if (ns[k][w] > hi[k]) hi[k] = ns[k][w];
+        }
+    }
+    /* The block kernel drops to bypass once the tail is inaudible, so only
+     * the reference spread is a flatness figure */
+    printf("# reference max/min %.2f, block max %.2f ns/frame\n", hi[0] / lo[0], hi[1]);
+}
+
+int main(int argc, char **argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    if (seconds <= 0.0) seconds = 2.0;
+
+    host_api_v1_t host = {0};
+    host.log = bench_log;
+    host.sample_rate = BENCH_SAMPLE_RATE;
+
+    const int block_sizes[] = { 32, 128, 512 };
+    const int instance_counts[] = { 1, 4, BENCH_MAX_INSTANCES };
+    cycles_init();
+
+    printf("# %.1fs per configuration, cycles from %s; per-frame figures are per instance\n",
+           seconds, g_cycle_source);
+    printf("%-8s %-10s %5s %4s %9s %12s %7s %7s %7s %7s\n",
+           "signal", "pattern", "block", "inst", "ns/frame", "cycles/frame", "load%", "front", "tone", "back");
+
+    for (int s = 0; s < SIGNAL_COUNT; s++) {
+        for (int p = 0; p < PATTERN_COUNT; p++) {
+            for (size_t b = 0; b < sizeof(block_sizes) / sizeof(block_sizes[0]); b++) {
+                for (size_t c = 0; c < sizeof(instance_counts) / sizeof(instance_counts[0]); c++) {
+                    const int block = block_sizes[b], count = instance_counts[c];
+                    /* Block size comes from the host at create time */
+                    host.frames_per_block = block;
+                    audio_fx_api_v2_t *api = move_audio_fx_init_v2(&host);
+                    if (!api) {
+                        fprintf(stderr, "failed to initialize API\n");
+                        return 1;
+                    }
+
+                    int64_t frames = (int64_t)(seconds * BENCH_SAMPLE_RATE) / block * block;
+                    BenchResult plain, staged;
+                    run(api, (Signal)s, (Pattern)p, block, count, frames, 0, &plain);
+                    run(api, (Signal)s, (Pattern)p, block, count, frames, 1, &staged);
+
+                    const double per = 1.0 / ((double)frames * count);
+                    const double ns = (double)plain.ns * per;
+                    const double budget = 1e9 / BENCH_SAMPLE_RATE;
+                    char cycles[32];
+                    if (plain.cycles) snprintf(cycles, sizeof(cycles), "%.1f", (double)plain.cycles * per);
+                    else snprintf(cycles, sizeof(cycles), "-");
+                    printf("%-8s %-10s %5d %4d %9.2f %12s %7.2f %7.2f %7.2f %7.2f\n",
+                           signal_names[s], pattern_names[p], block, count, ns, cycles,
+                           100.0 * ns * count / budget,
+                           (double)staged.stage_ns[0] * per, (double)staged.stage_ns[1] * per,
+                           (double)staged.stage_ns[2] * per);
+                    fflush(stdout);
+                }
+            }
+        }
+    }
+
+    bench_decay(&host);
+
+    if (g_perf_fd >= 0) close(g_perf_fd);
+    return 0;
+}
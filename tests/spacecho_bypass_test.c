@@ -0,0 +1,93 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+#define FRAMES 128
+
+/* A fresh instance fed silence must not touch its delay line at all */
+static int test_idle_instance_is_skipped(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *inst = (spacecho_instance_t *)api->create_instance(NULL, "{}");
+    int16_t block[FRAMES * 2] = {0};
+
+    for (int b = 0; b < 100; b++) {
+        api->process_block(inst, block, FRAMES);
+    }
+    int pos = inst->delayLine.writePosition;
+    api->destroy_instance(inst);
+
+    if (pos != 0) {
+        fprintf(stderr, "idle instance advanced its delay line to %d\n", pos);
+        return 1;
+    }
+    for (int i = 0; i < FRAMES * 2; i++) {
+        if (block[i] != 0) {
+            fprintf(stderr, "idle instance produced non-zero output\n");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Impulse, decay into bypass, second impulse: must track the reference kernel */
+static int test_decay_and_resume_match_reference(audio_fx_api_v2_t *api) {
+    RefPair pair;
+    if (RefPair_Open(&pair, api, "{}") != 0) return 1;
+    RefPair_Set(&pair, "feedback", "0.5");
+
+    int bypassed = 0;
+    const int blocks = 44100 * 12 / FRAMES;
+    const int second_impulse = 44100 * 10 / FRAMES;
+    for (int n = 0; n < blocks; n++) {
+        pair.in[0] = (n == 0 || n == second_impulse) ? 30000 : 0;
+        pair.in[1] = -pair.in[0];
+
+        int d = RefPair_Run(&pair, FRAMES);
+
+        if (n < second_impulse && kernel_tail_inaudible(pair.blk)) bypassed = 1;
+        if (d > 1) {
+            fprintf(stderr, "block %d: bypass output deviates from reference by %d LSB\n", n, d);
+            return 1;
+        }
+    }
+    RefPair_Close(&pair);
+
+    if (!bypassed) {
+        fprintf(stderr, "decayed tail never entered bypass\n");
+        return 1;
+    }
+    return 0;
+}
+
+/* With mix settled at 0 the block is passed through untouched */
+static int test_zero_mix_passes_input(audio_fx_api_v2_t *api) {
+    void *inst = api->create_instance(NULL, "{}");
+    api->set_param(inst, "mix", "0");
+
+    int16_t block[FRAMES * 2];
+    for (int n = 0; n < 100; n++) {
+        for (int i = 0; i < FRAMES * 2; i++) block[i] = (int16_t)((i * 977 + n * 31) % 20000 - 10000);
+        api->process_block(inst, block, FRAMES);
+    }
+    for (int i = 0; i < FRAMES * 2; i++) {
+        if (block[i] != (int16_t)((i * 977 + 99 * 31) % 20000 - 10000)) {
+            fprintf(stderr, "mix=0 altered sample %d\n", i);
+            return 1;
+        }
+    }
+    api->destroy_instance(inst);
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+
+    if (test_idle_instance_is_skipped(api) != 0) return 1;
+    if (test_decay_and_resume_match_reference(api) != 0) return 1;
+    if (test_zero_mix_passes_input(api) != 0) return 1;
+    return 0;
+}
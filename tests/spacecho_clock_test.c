@@ -0,0 +1,122 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+/* Drive MIDI clock at a tempo curve, delivering ticks before the block they
+ * fall in. sample_accurate passes the in-block offset; otherwise offset 0. */
+static float run_clock(audio_fx_api_v2_t *api, void *inst, float bpm_start, float bpm_end,
+                       int blocks, int sample_accurate, float *max_step_ms) {
+    const uint8_t tick = 0xF8;
+    const int block_frames = 128;
+    int16_t block[128 * 2] = {0};
+    double next_tick = 0.0;
+    float last_ms = -1.0f;
+    *max_step_ms = 0.0f;
+    for (int b = 0; b < blocks; b++) {
+        double block_start = (double)b * block_frames;
+        float bpm = bpm_start + (bpm_end - bpm_start) * (float)b / (float)blocks;
+        while (next_tick < block_start + block_frames) {
+            int offset = sample_accurate ? (int)(next_tick - block_start) : 0;
+            move_audio_fx_on_midi_at(inst, &tick, 1, 0, offset);
+            next_tick += 44100.0 * 60.0 / ((double)bpm * CLOCKS_PER_QUARTER);
+        }
+        api->process_block(inst, block, block_frames);
+
+        /* Once locked, the synced delay target must move in small steps */
+        float ms = ((spacecho_instance_t*)inst)->smoothedDelayTime.targetValue * 1000.0f;
+        if (b > 500 && fabsf(ms - last_ms) > *max_step_ms) *max_step_ms = fabsf(ms - last_ms);
+        last_ms = ms;
+    }
+    char buf[16];
+    api->get_param(inst, "bpm", buf, sizeof(buf));
+    return (float)atof(buf);
+}
+
+static int test_steady_tempo(audio_fx_api_v2_t *api) {
+    for (int accurate = 0; accurate < 2; accurate++) {
+        void *inst = api->create_instance(NULL, "{}");
+        api->set_param(inst, "division", "1/4");
+        float step;
+        float bpm = run_clock(api, inst, 127.3f, 127.3f, 3000, accurate, &step);
+        api->destroy_instance(inst);
+        float tolerance = accurate ? 0.01f : 0.1f;
+        if (fabsf(bpm - 127.3f) > tolerance) {
+            fprintf(stderr, "steady clock (accurate=%d) tracked %.3f BPM, expected 127.3\n", accurate, bpm);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int test_tempo_ramp(audio_fx_api_v2_t *api) {
+    void *inst = api->create_instance(NULL, "{}");
+    api->set_param(inst, "division", "1/4");
+    float step;
+    /* 100 -> 140 BPM over ~17s */
+    float bpm = run_clock(api, inst, 100.0f, 140.0f, 6000, 1, &step);
+    api->destroy_instance(inst);
+    /* The fit reports the mean tempo over its window, about one beat behind */
+    if (fabsf(bpm - 140.0f) > 1.5f) {
+        fprintf(stderr, "ramp ended at %.3f BPM\n", bpm);
+        return 1;
+    }
+    /* Quarter-note time falls ~171ms over 6000 blocks; integer BPM steps
+     * would jump ~4ms at a time */
+    if (step > 0.5f) {
+        fprintf(stderr, "synced time stair-steps by %.3f ms\n", step);
+        return 1;
+    }
+    return 0;
+}
+
+/* Division changes between ticks of a changing tempo: the audio thread's time
+ * follows the newest clock tempo, never an older one queued by set_param, and
+ * get_param reports the same tempo and time */
+static int test_division_during_tempo_change(audio_fx_api_v2_t *api) {
+    void *inst = api->create_instance(NULL, "{}");
+    spacecho_instance_t *si = (spacecho_instance_t*)inst;
+    const uint8_t tick = 0xF8;
+    api->set_param(inst, "division", "1/4");
+    int16_t block[128 * 2] = {0};
+    double next_tick = 0.0;
+    int stale = 0, unreported = 0;
+    for (int b = 0; b < 1500; b++) {
+        double bpm = b < 1000 ? 100.0 : 140.0;
+        const char *division = (b & 1) ? "1/2" : "1/4";
+        if (b >= 1000) api->set_param(inst, "division", division);
+        while (next_tick < (double)(b + 1) * 128) {
+            move_audio_fx_on_midi_at(inst, &tick, 1, 0, (int)(next_tick - (double)b * 128));
+            next_tick += 44100.0 * 60.0 / (bpm * CLOCKS_PER_QUARTER);
+        }
+        api->process_block(inst, block, 128);
+        if (b < 1000) continue;
+
+        char buf[16];
+        api->get_param(inst, "bpm", buf, sizeof(buf));
+        float want = compute_synced_time(si->syncBpm, (b & 1) ? DIV_1_2 : DIV_1_4);
+        if (fabsf(si->smoothedDelayTime.targetValue * 1000.0f - want) > 0.001f) stale++;
+        if (fabsf((float)atof(buf) - si->syncBpm) > 0.005f || si->param_time != (int)(want + 0.5f)) unreported++;
+    }
+    api->destroy_instance(inst);
+    if (stale || unreported) {
+        fprintf(stderr, "division during tempo change: %d stale targets, %d blocks misreported\n",
+                stale, unreported);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+
+    if (test_steady_tempo(api) != 0) return 1;
+    if (test_tempo_ramp(api) != 0) return 1;
+    if (test_division_during_tempo_change(api) != 0) return 1;
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+static int state_subnormal(const spacecho_instance_t *inst) {
+    for (int ch = 0; ch < MAX_CHANNELS; ch++) {
+        if (fpclassify(inst->toneFilter[ch].z1) == FP_SUBNORMAL ||
+            fpclassify(inst->allpassState[ch]) == FP_SUBNORMAL) return 1;
+    }
+    for (int i = 0; i < inst->delayLine.bufferLength * 2; i++) {
+        if (fpclassify(inst->delayLine.buffer[i]) == FP_SUBNORMAL) return 1;
+    }
+    return 0;
+}
+
+/* An impulse decaying through the slowest tone filter and the allpass
+ * interpolator ends in exact zeros, not stuck subnormals, and each call hands
+ * the caller's floating-point mode back unchanged */
+static int test_decay(audio_fx_api_v2_t *api, int reference) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    api->set_param(inst, "feedback", "0.5");
+    api->set_param(inst, "time", "20");
+    api->set_param(inst, "tone", "0.0");
+    api->set_param(inst, "quality", "allpass");
+
+    int16_t block[128 * 2];
+#ifdef SPACECHO_HAVE_FTZ
+    const uint64_t mode = ftz_read();
+#endif
+    for (int blk = 0; blk < 1400; blk++) {  /* ~4 s */
+        memset(block, 0, sizeof(block));
+        if (blk == 100) block[0] = block[1] = 30000;
+        if (reference) v2_process_block_reference(inst, block, 128);
+        else api->process_block(inst, block, 128);
+#ifdef SPACECHO_HAVE_FTZ
+        if (ftz_read() != mode) {
+            fprintf(stderr, "floating-point mode not restored\n");
+            return 1;
+        }
+#endif
+    }
+
+    int stuck = state_subnormal(inst);
+    float z1 = inst->toneFilter[0].z1;
+    api->destroy_instance(inst);
+    if (stuck || z1 != 0.0f) {
+        fprintf(stderr, "%s kernel left subnormal state after the tail (z1 %g)\n",
+                reference ? "reference" : "block", z1);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+
+#ifdef SPACECHO_HAVE_FTZ
+    /* -Ofast startup code may have set FZ process-wide; start from a host
+     * audio thread that does not flush */
+    ftz_write(ftz_read() & ~(uint64_t)FTZ_BITS);
+#endif
+
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+
+    if (test_decay(api, 1) != 0) return 1;
+    if (test_decay(api, 0) != 0) return 1;
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+/* The approximation tracks tanh, is odd, monotonic and bounded by 1/gain */
+static int test_soft_clip_shape(void) {
+    float worst = 0.0f, prev = -2.0f;
+    for (int i = -4000; i <= 4000; i++) {
+        float x = (float)i / 1000.0f;
+        float y = SoftClip(x, 1.0f);
+        float err = fabsf(y - tanhf(x));
+        if (err > worst) worst = err;
+        if (y < prev - 1e-6f || SoftClip(-x, 1.0f) != -y) {  /* flat to rounding near the knee */
+            fprintf(stderr, "soft clip not odd/monotonic at %g\n", x);
+            return 1;
+        }
+        prev = y;
+        if (fabsf(SoftClip(x, 4.0f)) > 0.25f + 1e-6f) {
+            fprintf(stderr, "soft clip exceeds 1/gain at %g\n", x);
+            return 1;
+        }
+    }
+    if (worst > 0.025f) {
+        fprintf(stderr, "soft clip deviates from tanh by %g\n", worst);
+        return 1;
+    }
+    return 0;
+}
+
+/* Driven kernel (settled, then ramping drive) agrees with the reference */
+static int test_matches_reference(audio_fx_api_v2_t *api, const char *oversampling) {
+    RefPair pair;
+    if (RefPair_Open(&pair, api, "{}") != 0) return 1;
+    const char *keys[] = { "feedback", "mix", "drive", "stereo_width", "oversampling" };
+    const char *vals[] = { "0.9", "0.8", "0.6", "40", oversampling };
+    RefPair_SetList(&pair, keys, vals, 5);
+
+    int max_diff = 0;
+    for (int blkIdx = 0; blkIdx < 800; blkIdx++) {
+        if (blkIdx == 400) RefPair_Set(&pair, "drive", "1.0");
+        for (int i = 0; i < 256; i++) pair.in[i] = (blkIdx < 150) ? noise_sample() : 0;
+        int d = RefPair_Run(&pair, 128);
+        if (d > max_diff) max_diff = d;
+    }
+    RefPair_Close(&pair);
+    if (max_diff > 1) {
+        fprintf(stderr, "driven kernel (oversampling %s) deviates from reference by %d LSB\n",
+                oversampling, max_diff);
+        return 1;
+    }
+    return 0;
+}
+
+static double goertzel_power(const float *x, int n, double freq, double rate) {
+    double coeff = 2.0 * cos(2.0 * 3.14159265358979 * freq / rate), s1 = 0.0, s2 = 0.0;
+    for (int i = 0; i < n; i++) {
+        double s0 = x[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    return s1 * s1 + s2 * s2 - coeff * s1 * s2;
+}
+
+/* Without drive the resampler pair is a pure delay in the passband; with
+ * drive a 15kHz tone's third harmonic stops folding back to 900Hz (-30dB or better) */
+static int test_oversampling(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    const int n = 4096, chunk = 128;
+    float *in = malloc(n * sizeof(float)), *out = malloc(n * sizeof(float));
+    double alias[3];
+    for (int os = OVERSAMPLING_OFF; os <= OVERSAMPLING_4X; os++) {
+        const int latency = os == OVERSAMPLING_4X ? 28 : 24;
+        inst->oversampling = os;
+        memset(inst->halfband, 0, sizeof(inst->halfband));
+        for (int i = 0; i < n; i++) in[i] = out[i] = 0.5f * sinf(2.0f * 3.14159265f * 1000.0f * i / 44100.0f);
+        if (os != OVERSAMPLING_OFF) {
+            for (int i = 0; i < n; i += chunk) saturate_oversampled(inst, 0, out + i, NULL, 1.0f, chunk);
+            float worst = 0.0f;
+            for (int i = 1000; i < n; i++) {
+                float err = fabsf(out[i] - in[i - latency]);
+                if (err > worst) worst = err;
+            }
+            if (worst > 1e-3f) {
+                fprintf(stderr, "%s resampler is not a %d-sample delay (error %g)\n",
+                        oversampling_names[os], latency, worst);
+                return 1;
+            }
+        }
+
+        for (int i = 0; i < n; i++) out[i] = 0.9f * sinf(2.0f * 3.14159265f * 15000.0f * i / 44100.0f);
+        for (int i = 0; i < n; i += chunk) {
+            if (os == OVERSAMPLING_OFF) SoftClip_Block(out + i, NULL, 4.0f, chunk);
+            else saturate_oversampled(inst, 0, out + i, NULL, 4.0f, chunk);
+        }
+        alias[os] = goertzel_power(out + 1024, n - 1024, 900.0, 44100.0);
+    }
+    free(in);
+    free(out);
+    api->destroy_instance(inst);
+
+    if (alias[OVERSAMPLING_2X] > alias[OVERSAMPLING_OFF] * 1e-3 ||
+        alias[OVERSAMPLING_4X] > alias[OVERSAMPLING_OFF] * 1e-3) {
+        fprintf(stderr, "alias at 900Hz: off %g, 2x %g, 4x %g\n",
+                alias[OVERSAMPLING_OFF], alias[OVERSAMPLING_2X], alias[OVERSAMPLING_4X]);
+        return 1;
+    }
+    return 0;
+}
+
+/* Full feedback with drive sustains a bounded oscillation; without drive it decays */
+static int test_self_oscillation(audio_fx_api_v2_t *api) {
+    int peaks[2];
+    for (int driven = 0; driven < 2; driven++) {
+        void *inst = api->create_instance(NULL, "{}");
+        api->set_param(inst, "feedback", "1.0");
+        api->set_param(inst, "mix", "1.0");
+        api->set_param(inst, "tone", "1.0");
+        api->set_param(inst, "time", "50");
+        if (driven) api->set_param(inst, "drive", "1.0");
+
+        int16_t block[128 * 2];
+        int peak = 0;
+        for (int blkIdx = 0; blkIdx < 3000; blkIdx++) {  /* ~8.7 s */
+            for (int i = 0; i < 256; i++) block[i] = (blkIdx < 4) ? noise_sample() : 0;
+            api->process_block(inst, block, 128);
+            if (blkIdx < 2600) continue;
+            for (int i = 0; i < 256; i++) {
+                if (abs(block[i]) > peak) peak = abs(block[i]);
+            }
+        }
+        peaks[driven] = peak;
+        api->destroy_instance(inst);
+    }
+
+    /* 1/gain ceiling (0.25) plus the width level compensation headroom */
+    if (peaks[0] > 2000 || peaks[1] < 2000 || peaks[1] > 11000) {
+        fprintf(stderr, "self oscillation: clean peak %d, driven peak %d\n", peaks[0], peaks[1]);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(9001u);
+
+    if (test_soft_clip_shape() != 0) return 1;
+    if (test_matches_reference(api, "off") != 0) return 1;
+    if (test_matches_reference(api, "2x") != 0) return 1;
+    if (test_matches_reference(api, "4x") != 0) return 1;
+    if (test_oversampling(api) != 0) return 1;
+    if (test_self_oscillation(api) != 0) return 1;
+    return 0;
+}
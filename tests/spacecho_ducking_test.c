@@ -0,0 +1,89 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+#define FRAMES 128
+
+/* Wet-only output energy of a ducked and an unducked instance: while the
+ * input plays and after the follower has released */
+static int test_ducks_and_releases(audio_fx_api_v2_t *api) {
+    void *ducked = api->create_instance(NULL, "{}");
+    void *plain = api->create_instance(NULL, "{}");
+    const char *keys[] = { "feedback", "mix", "time" };
+    const char *vals[] = { "0.9", "1.0", "100" };
+    test_set_params(api, ducked, keys, vals, 3);
+    test_set_params(api, plain, keys, vals, 3);
+    api->set_param(ducked, "ducking", "1.0");
+
+    int16_t a[FRAMES * 2], b[FRAMES * 2];
+    double playing[2] = { 0.0, 0.0 }, released[2] = { 0.0, 0.0 };
+    for (int n = 0; n < 1020; n++) {
+        for (int i = 0; i < FRAMES * 2; i++) a[i] = b[i] = n < 500 ? noise_sample() : 0;
+        api->process_block(ducked, a, FRAMES);
+        api->process_block(plain, b, FRAMES);
+        for (int i = 0; i < FRAMES * 2; i++) {
+            if (n >= 100 && n < 500) {
+                playing[0] += (double)a[i] * a[i];
+                playing[1] += (double)b[i] * b[i];
+            } else if (n >= 913) {  /* 1.2s after the input stopped */
+                released[0] += (double)a[i] * a[i];
+                released[1] += (double)b[i] * b[i];
+            }
+        }
+    }
+    char buf[16];
+    api->get_param(ducked, "ducking", buf, sizeof(buf));
+    api->destroy_instance(ducked);
+    api->destroy_instance(plain);
+
+    /* Full depth at -12dBFS peaks keeps the wet path closed under loud input */
+    if (playing[0] > 0.01 * playing[1] || released[0] < 0.9 * released[1] || strcmp(buf, "1.00") != 0) {
+        fprintf(stderr, "ducking: wet energy %.3g of plain while playing, %.3g after release (param %s)\n",
+                playing[0] / playing[1], released[0] / released[1], buf);
+        return 1;
+    }
+    return 0;
+}
+
+/* Bursts, a depth change, ducking off and back on track the reference kernel */
+static int test_matches_reference(audio_fx_api_v2_t *api) {
+    RefPair pair;
+    if (RefPair_Open(&pair, api, "{}") != 0) return 1;
+    const char *keys[] = { "feedback", "mix", "taps", "ducking" };
+    const char *vals[] = { "0.6", "0.6", "1", "0.8" };
+    RefPair_SetList(&pair, keys, vals, 4);
+
+    int maxDiff = 0;
+    for (int n = 0; n < 1600; n++) {
+        const char *val = n == 500 ? "0.3" : n == 900 ? "0" : n == 1100 ? "1" : NULL;
+        if (val) RefPair_Set(&pair, "ducking", val);
+        int loud = (n / 150) % 2 == 0;
+        for (int i = 0; i < FRAMES * 2; i++) {
+            pair.in[i] = (int16_t)(loud ? noise_sample() : noise_sample() / 16);
+        }
+        int d = RefPair_Run(&pair, FRAMES);
+        if (d > maxDiff) maxDiff = d;
+    }
+    RefPair_Close(&pair);
+
+    if (maxDiff > 1) {
+        fprintf(stderr, "ducking: block kernel deviates from reference by %d LSB\n", maxDiff);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(8086u);
+
+    if (test_ducks_and_releases(api) != 0) return 1;
+    if (test_matches_reference(api) != 0) return 1;
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+#define FRAMES 128
+
+/* Float blocks fed the int16 path's input carry the same signal: quantized
+ * the way kernel_encode does, they reproduce the int16 output exactly */
+static int test_matches_int16(audio_fx_api_v2_t *api, int interleaved) {
+    void *ref = api->create_instance(NULL, "{}");
+    void *flt = api->create_instance(NULL, "{}");
+    const char *keys[] = { "feedback", "mix", "taps", "tap1_time", "quality" };
+    const char *vals[] = { "0.7", "0.6", "1", "150", "hermite" };
+    test_set_params(api, ref, keys, vals, 5);
+    test_set_params(api, flt, keys, vals, 5);
+
+    int16_t a[FRAMES * 2];
+    float inter[FRAMES * 2], planeL[FRAMES], planeR[FRAMES];
+    float *l = interleaved ? inter : planeL, *r = interleaved ? inter + 1 : planeR;
+    int stride = interleaved ? 2 : 1;
+    int mismatches = 0;
+    for (int blk = 0; blk < 1200; blk++) {
+        if (blk == 400) {
+            api->set_param(ref, "time", "250");
+            api->set_param(flt, "time", "250");
+        }
+        for (int i = 0; i < FRAMES * 2; i++) a[i] = (blk < 300) ? noise_sample() : 0;
+        for (int i = 0; i < FRAMES; i++) {
+            l[i * stride] = a[i * 2] / 32768.0f;
+            r[i * stride] = a[i * 2 + 1] / 32768.0f;
+        }
+        api->process_block(ref, a, FRAMES);
+        move_audio_fx_process_block_f32(flt, l, r, stride, FRAMES);
+        for (int i = 0; i < FRAMES; i++) {
+            int16_t outL = (int16_t)(fminf(fmaxf(l[i * stride], -1.0f), 1.0f) * 32767.0f);
+            int16_t outR = (int16_t)(fminf(fmaxf(r[i * stride], -1.0f), 1.0f) * 32767.0f);
+            if (outL != a[i * 2] || outR != a[i * 2 + 1]) mismatches++;
+        }
+    }
+    api->destroy_instance(ref);
+    api->destroy_instance(flt);
+
+    if (mismatches) {
+        fprintf(stderr, "%s float blocks: %d frames differ from the int16 path\n",
+                interleaved ? "interleaved" : "planar", mismatches);
+        return 1;
+    }
+    return 0;
+}
+
+/* A hot input with strong feedback sums past full scale without clipping */
+static int test_headroom(audio_fx_api_v2_t *api) {
+    void *inst = api->create_instance(NULL, "{}");
+    api->set_param(inst, "feedback", "0.9");
+    api->set_param(inst, "mix", "0.5");
+    api->set_param(inst, "time", "50");
+
+    float l[FRAMES], r[FRAMES];
+    float peak = 0.0f;
+    for (int blk = 0; blk < 200; blk++) {
+        for (int i = 0; i < FRAMES; i++) l[i] = r[i] = 0.95f;
+        move_audio_fx_process_block_f32(inst, l, r, 1, FRAMES);
+        for (int i = 0; i < FRAMES; i++) {
+            if (!isfinite(l[i]) || !isfinite(r[i])) peak = NAN;
+            peak = fmaxf(peak, fmaxf(fabsf(l[i]), fabsf(r[i])));
+        }
+    }
+    api->destroy_instance(inst);
+
+    if (!(peak > 1.0f)) {
+        fprintf(stderr, "float output peaked at %g, expected headroom past 1.0\n", peak);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(2718u);
+
+    if (test_matches_int16(api, 0) != 0) return 1;
+    if (test_matches_int16(api, 1) != 0) return 1;
+    if (test_headroom(api) != 0) return 1;
+    return 0;
+}
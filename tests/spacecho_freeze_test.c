@@ -0,0 +1,129 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+#define FRAMES 128
+
+/* Frozen, the delay buffer is never written and, once the tone filter has
+ * gone round the loop once, the wet output repeats with the loop length
+ * exactly, whatever comes in */
+static int test_loop_holds(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    api->set_param(inst, "time", "250");  /* 11025 frames at 44.1kHz */
+    api->set_param(inst, "feedback", "0.5");
+    api->set_param(inst, "mix", "1.0");
+    api->set_param(inst, "taps", "1");
+
+    int16_t block[FRAMES * 2];
+    for (int blk = 0; blk < 200; blk++) {
+        for (int i = 0; i < FRAMES * 2; i++) block[i] = noise_sample();
+        api->process_block(inst, block, FRAMES);
+    }
+    api->set_param(inst, "freeze", "on");
+
+    const int loop = 11025, total = 3 * loop;
+    size_t bytes = (size_t)inst->delayLine.bufferLength * 2 * sizeof(float);
+    float *snapshot = malloc(bytes);
+    int16_t *out = malloc((size_t)(total + FRAMES) * 2 * sizeof(int16_t));
+    memcpy(snapshot, inst->delayLine.buffer, bytes);
+    int written = 0;
+    while (written < total) {
+        for (int i = 0; i < FRAMES * 2; i++) block[i] = noise_sample();
+        api->process_block(inst, block, FRAMES);  /* mix 1: input does not reach the output */
+        memcpy(out + written * 2, block, sizeof(block));
+        written += FRAMES;
+    }
+    int untouched = memcmp(snapshot, inst->delayLine.buffer, bytes) == 0;
+    int periodic = 1, nonzero = 0;
+    for (int i = loop * 2; i < (total - loop) * 2; i++) {  /* past the tone filter's entry transient */
+        if (out[i] != out[i + loop * 2]) periodic = 0;
+        if (out[i] != 0) nonzero = 1;
+    }
+    char buf[8];
+    api->get_param(inst, "freeze", buf, sizeof(buf));
+    free(snapshot);
+    free(out);
+    api->destroy_instance(inst);
+
+    if (!untouched || !periodic || !nonzero || strcmp(buf, "on") != 0) {
+        fprintf(stderr, "freeze: buffer %s, output %s%s, param %s\n", untouched ? "held" : "written",
+                periodic ? "periodic" : "not periodic", nonzero ? "" : " (silent)", buf);
+        return 1;
+    }
+    return 0;
+}
+
+/* Freeze, a loop-length change while frozen and release track the reference
+ * kernel */
+static int test_matches_reference(audio_fx_api_v2_t *api) {
+    RefPair pair;
+    if (RefPair_Open(&pair, api, "{}") != 0) return 1;
+    const char *keys[] = { "feedback", "mix", "tone", "taps", "tap1_time" };
+    const char *vals[] = { "0.6", "0.7", "0.4", "1", "120" };
+    RefPair_SetList(&pair, keys, vals, 5);
+
+    int maxStatic = 0, maxRamp = 0;
+    for (int n = 0; n < 2000; n++) {
+        const char *key = NULL, *val = NULL;
+        if (n == 400) key = "freeze", val = "on";
+        if (n == 900) key = "time", val = "300";
+        if (n == 1400) key = "freeze", val = "off";
+        if (key) RefPair_Set(&pair, key, val);
+        for (int i = 0; i < FRAMES * 2; i++) {
+            pair.in[i] = (n < 300 || (n > 600 && n < 700)) ? noise_sample() : 0;
+        }
+        int d = RefPair_Run(&pair, FRAMES);
+        int *max = n < 900 ? &maxStatic : &maxRamp;
+        if (d > *max) *max = d;
+    }
+    RefPair_Close(&pair);
+
+    if (maxStatic > 1 || maxRamp > 16) {
+        fprintf(stderr, "freeze: block kernel deviates from reference by %d LSB (static), %d LSB (ramp)\n",
+                maxStatic, maxRamp);
+        return 1;
+    }
+    return 0;
+}
+
+/* A restored state neither engages nor releases freeze, whatever form the key takes */
+static int test_state_skips_freeze(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    int16_t block[FRAMES * 2] = {0};
+    api->set_param(inst, "state", "{\"freeze\":1,\"feedback\":0.3}");
+    api->set_param(inst, "state", "{\"freeze\":\"on\"}");
+    api->process_block(inst, block, FRAMES);
+    int engaged = inst->frozen;
+    char buf[8], feedback[8];
+    api->get_param(inst, "freeze", buf, sizeof(buf));
+    api->get_param(inst, "feedback", feedback, sizeof(feedback));
+
+    api->set_param(inst, "freeze", "on");
+    api->set_param(inst, "state", "{\"freeze\":0}");
+    api->process_block(inst, block, FRAMES);
+    int held = inst->frozen;
+    api->destroy_instance(inst);
+
+    if (engaged || !held || strcmp(buf, "off") != 0 || strcmp(feedback, "0.30") != 0) {
+        fprintf(stderr, "freeze: state restore %s freeze (param %s, feedback %s)\n",
+                engaged ? "engaged" : "released", buf, feedback);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(5150u);
+
+    if (test_loop_holds(api) != 0) return 1;
+    if (test_matches_reference(api) != 0) return 1;
+    if (test_state_skips_freeze(api) != 0) return 1;
+    return 0;
+}
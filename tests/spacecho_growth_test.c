@@ -0,0 +1,200 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+/* The service thread answers asynchronously; give it up to a second */
+static int wait_for_state(DelayGrowth *g, int state) {
+    for (int k = 0; k < 1000 && atomic_load(&g->state) != state; k++) usleep(1000);
+    return atomic_load(&g->state);
+}
+
+/* The buffer covers the initial time by default and max_delay_ms when given */
+static int test_initial_length(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *small = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    spacecho_instance_t *big = (spacecho_instance_t*)api->create_instance(NULL, "{\"max_delay_ms\":2000}");
+    int smallLength = small->delayLine.bufferLength, bigLength = big->delayLine.bufferLength;
+    int maxLength = big->delayGrowth.maxLength;
+    api->destroy_instance(small);
+    api->destroy_instance(big);
+
+    if (smallLength != 32768 || bigLength != maxLength || bigLength != 131072) {
+        fprintf(stderr, "initial lengths: default %d, max_delay_ms 2000 %d (max %d)\n",
+                smallLength, bigLength, maxLength);
+        return 1;
+    }
+    return 0;
+}
+
+/* Growing mid-stream to a longer time sounds exactly like a preallocated
+ * buffer, and the service thread frees the replaced buffer */
+static int test_grow_matches_preallocated(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *grow = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    void *full = api->create_instance(NULL, "{\"max_delay_ms\":2000}");
+    const char *keys[] = { "time", "feedback", "mix", "taps", "tap1_time" };
+    const char *vals[] = { "300", "0.6", "0.7", "1", "250" };
+    test_set_params(api, grow, keys, vals, 5);
+    test_set_params(api, full, keys, vals, 5);
+
+    int16_t a[128 * 2], b[128 * 2];
+    int mismatches = 0;
+    for (int blk = 0; blk < 2500; blk++) {
+        if (blk == 1200) {
+            api->set_param(grow, "time", "1500");
+            api->set_param(full, "time", "1500");
+        }
+        if (blk == 1600) {
+            api->set_param(grow, "tap1_time", "1900");
+            api->set_param(full, "tap1_time", "1900");
+        }
+        /* Silence first so both buffers only ever hold what the small one can */
+        for (int i = 0; i < 256; i++) {
+            a[i] = (blk >= 1000 && blk < 1800) ? noise_sample() : 0;
+            b[i] = a[i];
+        }
+        api->process_block(grow, a, 128);
+        api->process_block(full, b, 128);
+        if (memcmp(a, b, sizeof(a)) != 0) mismatches++;
+    }
+
+    int grownLength = grow->delayLine.bufferLength;
+    int state = wait_for_state(&grow->delayGrowth, DELAY_GROW_IDLE);
+    api->destroy_instance(grow);
+    api->destroy_instance(full);
+
+    if (mismatches || grownLength != 131072 || state != DELAY_GROW_IDLE) {
+        fprintf(stderr, "growth: %d mismatched blocks, length %d, state %d\n",
+                mismatches, grownLength, state);
+        return 1;
+    }
+    return 0;
+}
+
+/* Frames the audio thread writes while another thread copies the history
+ * are the ones after the write count it last published. Publishing a count
+ * 'stale' frames old before the copy puts those frames (and the slots they
+ * overwrote) after it, as a slow copy would. The history has wrapped and
+ * its oldest frames, the ones the copy leaves to the audio thread, carry
+ * input; once a long time reads the grown buffer the output still matches
+ * a preallocated one, for a catch-up shorter and longer than the guard. */
+static int test_frames_during_copy(audio_fx_api_v2_t *api, int stale) {
+    spacecho_instance_t *grow = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    void *full = api->create_instance(NULL, "{\"max_delay_ms\":2000}");
+    const char *keys[] = { "time", "feedback", "mix" };
+    const char *vals[] = { "700", "0.5", "0.7" };
+    test_set_params(api, grow, keys, vals, 3);
+    test_set_params(api, full, keys, vals, 3);
+
+    int16_t a[128 * 2], b[128 * 2];
+    int mismatches = 0, taken = 0;
+    for (int blk = 0; blk < 1600; blk++) {
+        if (blk == 455) {
+            /* Input since block 200 still fits the small buffer */
+            atomic_store(&grow->delayGrowth.written, grow->delayLine.written - (uint32_t)stale);
+            DelayGrowth_Reserve(&grow->delayGrowth, 65536);
+        }
+        if (blk == 457) {
+            api->set_param(grow, "time", "1400");  /* fits the buffer taken at 455 */
+            api->set_param(full, "time", "1400");
+        }
+        for (int i = 0; i < 256; i++) a[i] = b[i] = blk >= 200 ? noise_sample() : 0;
+        api->process_block(grow, a, 128);
+        api->process_block(full, b, 128);
+        if (blk == 455) taken = grow->delayLine.written - grow->delayGrowth.copied;
+        if (memcmp(a, b, sizeof(a)) != 0) mismatches++;
+    }
+    int length = grow->delayLine.bufferLength;
+    api->destroy_instance(grow);
+    api->destroy_instance(full);
+
+    if (mismatches || length != 65536 || taken != stale + 128) {
+        fprintf(stderr, "frames during copy (%d stale): %d mismatched blocks, length %d, %d frames caught up\n",
+                stale, mismatches, length, taken);
+        return 1;
+    }
+    return 0;
+}
+
+/* A time that arrives on the audio thread asks the service thread for the
+ * buffer instead of allocating, and it is offered without any control call */
+static int test_audio_thread_request(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    ParamEvent ev = {0};
+    ev.type = PARAM_EVENT_DELAY_TIME;
+    ev.a = 1.2f;
+    apply_param_event(inst, &ev);
+    int want = atomic_load(&inst->delayGrowth.wantLength);
+
+    wait_for_state(&inst->delayGrowth, DELAY_GROW_READY);
+    int16_t block[128 * 2] = {0};
+    api->process_block(inst, block, 128);
+    int length = inst->delayLine.bufferLength;
+    api->destroy_instance(inst);
+
+    if (want != 65536 || length != 65536) {
+        fprintf(stderr, "audio thread request: want %d, length %d\n", want, length);
+        return 1;
+    }
+    return 0;
+}
+
+/* MIDI clock alone (no set_param/get_param after the division) grows the
+ * buffer for a long synced time; the echo then lands at the full time */
+static int test_clock_driven_growth(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    api->set_param(inst, "division", "1/2");
+    api->set_param(inst, "feedback", "0");
+    api->set_param(inst, "mix", "1");
+    const uint8_t tick = 0xF8;
+    const double tick_frames = 44100.0 * 60.0 / (70.0 * CLOCKS_PER_QUARTER);  /* 1/2 at 70 BPM: 1714ms */
+    double next_tick = 0.0;
+    int16_t block[128 * 2];
+    int peak = 0, peak_at = -1, impulse_at = -1;
+    for (int b = 0; b < 2000; b++) {
+        while (next_tick < (double)(b + 1) * 128) {
+            move_audio_fx_on_midi_at(inst, &tick, 1, 0, (int)(next_tick - (double)b * 128));
+            next_tick += tick_frames;
+        }
+        memset(block, 0, sizeof(block));
+        if (b == 700) {
+            block[0] = 30000;
+            impulse_at = b * 128;
+        }
+        api->process_block(inst, block, 128);
+        for (int i = 0; i < 128; i++) {
+            if (impulse_at >= 0 && abs(block[i * 2 + 1]) > peak) {
+                peak = abs(block[i * 2 + 1]);
+                peak_at = b * 128 + i;
+            }
+        }
+        if (b < 700) usleep(50);  /* the service thread runs while the host does */
+    }
+    int length = inst->delayLine.bufferLength;
+    api->destroy_instance(inst);
+
+    int expect = (int)lroundf(44100.0f * 60.0f / 70.0f * 2.0f);
+    if (length != 131072 || abs(peak_at - impulse_at - expect) > 4) {
+        fprintf(stderr, "clock growth: length %d, echo after %d frames, expected %d\n",
+                length, peak_at - impulse_at, expect);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(31337u);
+
+    if (test_initial_length(api) != 0) return 1;
+    if (test_grow_matches_preallocated(api) != 0) return 1;
+    if (test_frames_during_copy(api, 3 * 128) != 0) return 1;
+    if (test_frames_during_copy(api, DELAY_GROW_GUARD_FRAMES + 3 * 128) != 0) return 1;
+    if (test_audio_thread_request(api) != 0) return 1;
+    if (test_clock_driven_growth(api) != 0) return 1;
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+/* Jumps (including one queued behind a running crossfade) match the reference */
+static int test_matches_reference(audio_fx_api_v2_t *api, const char *quality, const char *wow) {
+    RefPair pair;
+    if (RefPair_Open(&pair, api, "{}") != 0) return 1;
+    const char *keys[] = { "time_mode", "quality", "feedback", "mix", "wow", "taps", "tap1_time" };
+    /* Modulated reads interpolate in both kernels, and the reference's float
+     * read position loses precision as the write position grows (glide mode
+     * shows the same), so the modulated run stops after the queued jump */
+    const int modulated = strcmp(wow, "0") != 0;
+    const int blocks = modulated ? 420 : 900;
+    const char *vals[] = { "jump", quality, "0.7", "1.0", wow, "1", "170" };
+    RefPair_SetList(&pair, keys, vals, 7);
+
+    int max_diff = 0;
+    for (int blkIdx = 0; blkIdx < blocks; blkIdx++) {
+        const char *time = blkIdx == 300 ? "250" : blkIdx == 302 ? "613" : blkIdx == 600 ? "90" : NULL;
+        if (time) RefPair_Set(&pair, "time", time);
+        for (int i = 0; i < 128 * 2; i++) pair.in[i] = (blkIdx < 700) ? noise_sample() : 0;
+        int d = RefPair_Run(&pair, 128);
+        if (d > max_diff) max_diff = d;
+    }
+    float final_time = ((spacecho_instance_t*)pair.blk)->smoothedDelayTime.currentValue;
+    int settled = fabsf(final_time - (modulated ? 0.613f : 0.09f)) < 1e-6f;
+    RefPair_Close(&pair);
+
+    int tolerance = modulated ? 32 : 2;
+    if (max_diff > tolerance || !settled) {
+        fprintf(stderr, "jump (%s, wow %s) deviates from reference by %d LSB (settled %d)\n",
+                quality, wow, max_diff, settled);
+        return 1;
+    }
+    return 0;
+}
+
+/* After a jump the echo lands exactly at the new time, with no glide */
+static int test_jump_is_instant(audio_fx_api_v2_t *api) {
+    void *inst = api->create_instance(NULL, "{}");
+    api->set_param(inst, "time_mode", "jump");
+    api->set_param(inst, "feedback", "0");
+    api->set_param(inst, "mix", "1");
+    api->set_param(inst, "time", "250");
+
+    const int frames = 44100;
+    int16_t *buffer = calloc((size_t)frames * 2, sizeof(int16_t));
+    buffer[2000 * 2] = 30000;  /* impulse just after the 20ms crossfade */
+    for (int offset = 0; offset < frames; offset += 128) {
+        int n = frames - offset < 128 ? frames - offset : 128;
+        api->process_block(inst, buffer + offset * 2, n);
+    }
+    int peak = 0, peak_at = -1;
+    for (int i = 2001; i < frames; i++) {
+        if (abs(buffer[i * 2 + 1]) > peak) {
+            peak = abs(buffer[i * 2 + 1]);
+            peak_at = i;
+        }
+    }
+    free(buffer);
+    api->destroy_instance(inst);
+    if (peak_at != 2000 + 11025) {
+        fprintf(stderr, "echo at frame %d, expected %d\n", peak_at, 2000 + 11025);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(4242u);
+
+    const char *qualities[] = { "linear", "hermite", "sinc" };
+    for (int q = 0; q < 3; q++) {
+        if (test_matches_reference(api, qualities[q], "0") != 0) return 1;
+    }
+    if (test_matches_reference(api, "linear", "0.8") != 0) return 1;
+    if (test_jump_is_instant(api) != 0) return 1;
+    return 0;
+}
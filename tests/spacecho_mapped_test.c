@@ -0,0 +1,81 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+#define FRAMES MOVE_FRAMES_PER_BLOCK
+
+/* A NULL block reads the mailbox input and writes the mailbox output exactly
+ * as an in-place block would, through active, wet-muted and bypassed chunks */
+static int test_matches_in_place(audio_fx_api_v2_t *api, uint8_t *mailbox) {
+    int16_t *mappedIn = (int16_t *)(mailbox + MOVE_AUDIO_IN_OFFSET);
+    int16_t *mappedOut = (int16_t *)(mailbox + MOVE_AUDIO_OUT_OFFSET);
+    void *mapped = api->create_instance(NULL, "{}");
+    void *inPlace = api->create_instance(NULL, "{}");
+    api->set_param(mapped, "feedback", "0.6");
+    api->set_param(inPlace, "feedback", "0.6");
+
+    int16_t expect[FRAMES * 2], input[FRAMES * 2];
+    int mismatches = 0;
+    for (int blk = 0; blk < 1500; blk++) {
+        if (blk == 500) {
+            api->set_param(mapped, "mix", "0");
+            api->set_param(inPlace, "mix", "0");
+        }
+        for (int i = 0; i < FRAMES * 2; i++) input[i] = (blk < 700) ? noise_sample() : 0;
+        memcpy(mappedIn, input, sizeof(input));
+        memset(mappedOut, 0x55, FRAMES * 2 * sizeof(int16_t));  /* stale host data */
+        memcpy(expect, input, sizeof(input));
+
+        api->process_block(mapped, NULL, FRAMES);
+        api->process_block(inPlace, expect, FRAMES);
+        if (memcmp(mappedOut, expect, sizeof(expect)) != 0 || memcmp(mappedIn, input, sizeof(input)) != 0) {
+            mismatches++;
+        }
+    }
+    api->destroy_instance(mapped);
+    api->destroy_instance(inPlace);
+
+    if (mismatches) {
+        fprintf(stderr, "%d mapped blocks differ from in-place processing\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
+
+/* Without a usable mapping a NULL block is ignored */
+static int test_unmapped_host(audio_fx_api_v2_t *api, host_api_v1_t *host) {
+    host->mapped_memory = NULL;
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    api->process_block(inst, NULL, FRAMES);
+    int64_t pos = inst->clock_sample_pos;
+    api->destroy_instance(inst);
+    if (pos != 0) {
+        fprintf(stderr, "NULL block without a mapping was processed\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    uint8_t *mailbox = aligned_alloc(4096, 4096);
+    if (!mailbox) return 1;
+    memset(mailbox, 0, 4096);
+
+    host_api_v1_t host = {0};
+    host.mapped_memory = mailbox;
+    host.audio_in_offset = MOVE_AUDIO_IN_OFFSET;
+    host.audio_out_offset = MOVE_AUDIO_OUT_OFFSET;
+
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(9001u);
+
+    if (test_matches_in_place(api, mailbox) != 0) return 1;
+    if (test_unmapped_host(api, &host) != 0) return 1;
+    free(mailbox);
+    return 0;
+}
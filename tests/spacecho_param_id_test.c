@@ -0,0 +1,93 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+/* Every chain_params key resolves to its own ID; unknown keys do not */
+static int test_key_ids(audio_fx_api_v2_t *api) {
+    void *inst = api->create_instance(NULL, "{}");
+    char chain[8192];
+    if (api->get_param(inst, "chain_params", chain, sizeof(chain)) < 0) {
+        fprintf(stderr, "chain_params did not fit\n");
+        return 1;
+    }
+    api->destroy_instance(inst);
+
+    int seen[PARAM_SETTABLE_COUNT] = {0};
+    int count = 0;
+    for (const char *p = strstr(chain, "\"key\":\""); p; p = strstr(p, "\"key\":\"")) {
+        p += 7;
+        char key[PARAM_KEY_MAX];
+        int n = 0;
+        while (p[n] && p[n] != '"' && n < PARAM_KEY_MAX - 1) { key[n] = p[n]; n++; }
+        key[n] = '\0';
+        int id = move_audio_fx_param_id(key);
+        if (id < 0 || seen[id]) {
+            fprintf(stderr, "chain_params key %s resolved to %d\n", key, id);
+            return 1;
+        }
+        seen[id] = 1;
+        count++;
+    }
+    if (count != PARAM_SETTABLE_COUNT) {
+        fprintf(stderr, "expected %d chain_params keys, found %d\n", PARAM_SETTABLE_COUNT, count);
+        return 1;
+    }
+
+    const char *unknown[] = { "", "tim", "timex", "tap0_time", "tap9_gain", "tap1_", "state", "bpm" };
+    for (int k = 0; k < 8; k++) {
+        if (move_audio_fx_param_id(unknown[k]) != -1) {
+            fprintf(stderr, "%s must not be settable by ID\n", unknown[k]);
+            return 1;
+        }
+    }
+    if (param_key_id("width") != PARAM_STEREO_WIDTH || param_key_id("bpm") != PARAM_BPM) {
+        fprintf(stderr, "alias / get-only keys did not resolve\n");
+        return 1;
+    }
+    return 0;
+}
+
+/* Setting by ID leaves the same state as setting by string */
+static int test_set_by_id(audio_fx_api_v2_t *api) {
+    void *a = api->create_instance(NULL, "{}");
+    void *b = api->create_instance(NULL, "{}");
+    const char *keys[] = { "time", "feedback", "tone", "stereo_width", "quality", "taps", "tap2_division", "tap1_pan" };
+    const char *strs[] = { "333", "0.55", "0.25", "40", "sinc", "2", "1/8d", "-2" };
+    const float nums[] = { 333.0f, 0.55f, 0.25f, 40.0f, (float)INTERP_SINC, 2.0f, (float)DIV_1_8D, -2.0f };
+    for (int k = 0; k < 8; k++) {
+        api->set_param(a, keys[k], strs[k]);
+        if (move_audio_fx_set_param_id(b, move_audio_fx_param_id(keys[k]), nums[k]) != 0) {
+            fprintf(stderr, "set by ID rejected %s\n", keys[k]);
+            return 1;
+        }
+    }
+    if (move_audio_fx_set_param_id(b, -1, 0.0f) != -1 || move_audio_fx_set_param_id(b, PARAM_STATE, 0.0f) != -1) {
+        fprintf(stderr, "set by ID accepted an invalid ID\n");
+        return 1;
+    }
+
+    char sa[2048], sb[2048];
+    api->get_param(a, "state", sa, sizeof(sa));
+    api->get_param(b, "state", sb, sizeof(sb));
+    api->destroy_instance(a);
+    api->destroy_instance(b);
+    if (strcmp(sa, sb) != 0) {
+        fprintf(stderr, "string and ID paths diverged:\n%s\n%s\n", sa, sb);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+
+    if (test_key_ids(api) != 0) return 1;
+    if (test_set_by_id(api) != 0) return 1;
+    return 0;
+}
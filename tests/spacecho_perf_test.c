@@ -0,0 +1,101 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPACECHO_PERF_STATS
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+static double json_number(const char *json, const char *key) {
+    char pattern[32];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *p = strstr(json, pattern);
+    return p ? atof(p + strlen(pattern)) : -1.0;
+}
+
+/* Timings are ordered, counters track blocks and ramps */
+static int test_report(audio_fx_api_v2_t *api) {
+    void *inst = api->create_instance(NULL, "{}");
+    char buf[512];
+    api->get_param(inst, "perf_stats", buf, sizeof(buf));
+    if (json_number(buf, "blocks") != 0.0 || json_number(buf, "ramps") != 0.0) {
+        fprintf(stderr, "fresh report not empty: %s\n", buf);
+        return 1;
+    }
+
+    /* Three ramping parameters, one mode switch that does not ramp */
+    api->set_param(inst, "feedback", "0.9");
+    api->set_param(inst, "mix", "1.0");
+    api->set_param(inst, "time", "30");
+    api->set_param(inst, "quality", "hermite");
+
+    int16_t block[128 * 2];
+    for (int blk = 0; blk < 1500; blk++) {
+        for (int i = 0; i < 256; i++) block[i] = (blk < 200) ? noise_full() : 0;
+        api->process_block(inst, block, 128);
+    }
+
+    int len = api->get_param(inst, "perf_stats", buf, sizeof(buf));
+    api->destroy_instance(inst);
+    if (len <= 0 || strstr(buf, "\"enabled\":true") == NULL) {
+        fprintf(stderr, "perf_stats not enabled: %s\n", buf);
+        return 1;
+    }
+
+    double minUs = json_number(buf, "min_us"), avgUs = json_number(buf, "avg_us");
+    double p99Us = json_number(buf, "p99_us"), maxUs = json_number(buf, "max_us");
+    if (json_number(buf, "blocks") != 1500.0 || json_number(buf, "window") != PERF_WINDOW ||
+        json_number(buf, "frames") != 128.0 ||
+        !(minUs >= 0.0 && minUs <= avgUs && avgUs <= maxUs && minUs <= p99Us && p99Us <= maxUs) ||
+        json_number(buf, "load_max") <= 0.0) {
+        fprintf(stderr, "inconsistent timings: %s\n", buf);
+        return 1;
+    }
+    if (json_number(buf, "ramps") != 3.0 || json_number(buf, "clips") != 0.0 ||
+        json_number(buf, "xruns") != 0.0) {
+        fprintf(stderr, "unexpected counters: %s\n", buf);
+        return 1;
+    }
+    return 0;
+}
+
+/* Stacked full-gain taps on top of the main head drive the output past full scale */
+static int test_clips(audio_fx_api_v2_t *api) {
+    void *inst = api->create_instance(NULL, "{}");
+    api->set_param(inst, "mix", "1.0");
+    api->set_param(inst, "taps", "4");
+    for (int t = 1; t <= 4; t++) {
+        char key[16];
+        snprintf(key, sizeof(key), "tap%d_gain", t);
+        api->set_param(inst, key, "1.0");
+        snprintf(key, sizeof(key), "tap%d_time", t);
+        api->set_param(inst, key, "500");
+    }
+
+    int16_t block[128 * 2];
+    for (int blk = 0; blk < 400; blk++) {
+        for (int i = 0; i < 256; i++) block[i] = noise_full();
+        api->process_block(inst, block, 128);
+    }
+
+    char buf[512];
+    api->get_param(inst, "perf_stats", buf, sizeof(buf));
+    api->destroy_instance(inst);
+    if (json_number(buf, "clips") <= 0.0) {
+        fprintf(stderr, "no clipped samples counted: %s\n", buf);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(777u);
+
+    if (test_report(api) != 0) return 1;
+    if (test_clips(api) != 0) return 1;
+    return 0;
+}
@@ -3,15 +3,13 @@
 #include <stdlib.h>
 
 #include "../src/dsp/spacecho.c"
-
-static void test_log(const char *msg) {
-    (void)msg;
-}
+#include "spacecho_test_util.h"
 
 static int run_impulse_case(audio_fx_api_v2_t *api,
                             const char *width_value,
                             int16_t impulse_left,
                             int16_t impulse_right,
+                            int delay_frame,
                             int *left_echo,
                             int *right_echo) {
     void *instance = api->create_instance(NULL, "{}");
@@ -52,7 +50,6 @@ static int run_impulse_case(audio_fx_api_v2_t *api,
 
     api->process_block(instance, buffer, frames);
 
-    const int delay_frame = 17640; /* 400ms default at 44.1kHz */
     *left_echo = abs(buffer[delay_frame * 2]);
     *right_echo = abs(buffer[delay_frame * 2 + 1]);
 
@@ -63,18 +60,14 @@ static int run_impulse_case(audio_fx_api_v2_t *api,
 
 int main(void) {
     host_api_v1_t host = {0};
-    host.log = test_log;
-
-    audio_fx_api_v2_t *api = move_audio_fx_init_v2(&host);
-    if (!api) {
-        fprintf(stderr, "failed to initialize API\n");
-        return 1;
-    }
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
 
     int left_echo = 0;
     int right_echo = 0;
+    const int delay_frame = 17640; /* 400ms default at 44.1kHz */
 
-    if (run_impulse_case(api, "100", 30000, 0, &left_echo, &right_echo) != 0) {
+    if (run_impulse_case(api, "100", 30000, 0, delay_frame, &left_echo, &right_echo) != 0) {
         return 1;
     }
 
@@ -93,7 +86,7 @@ int main(void) {
         return 1;
     }
 
-    if (run_impulse_case(api, "100", 30000, 30000, &left_echo, &right_echo) != 0) {
+    if (run_impulse_case(api, "100", 30000, 30000, delay_frame, &left_echo, &right_echo) != 0) {
         return 1;
     }
 
@@ -105,7 +98,7 @@ int main(void) {
         return 1;
     }
 
-    if (run_impulse_case(api, "0", 30000, 30000, &left_echo, &right_echo) != 0) {
+    if (run_impulse_case(api, "0", 30000, 30000, delay_frame, &left_echo, &right_echo) != 0) {
         return 1;
     }
 
@@ -117,7 +110,7 @@ int main(void) {
         return 1;
     }
 
-    if (run_impulse_case(api, NULL, 30000, 30000, &left_echo, &right_echo) != 0) {
+    if (run_impulse_case(api, NULL, 30000, 30000, delay_frame, &left_echo, &right_echo) != 0) {
         return 1;
     }
 
@@ -129,5 +122,22 @@ int main(void) {
         return 1;
     }
 
+    /* Instances created under a 48kHz host must size delays from its rate */
+    host.sample_rate = 48000;
+    host.frames_per_block = 128;
+    api = move_audio_fx_init_v2(&host);
+
+    if (run_impulse_case(api, NULL, 30000, 30000, 19200, &left_echo, &right_echo) != 0) {
+        return 1;
+    }
+
+    if (left_echo < 20000 || right_echo < 20000) {
+        fprintf(stderr,
+                "48kHz host expected echo at 19200 frames, got left=%d right=%d\n",
+                left_echo,
+                right_echo);
+        return 1;
+    }
+
     return 0;
 }
@@ -0,0 +1,114 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+/* Changes reach the DSP state only when the audio thread drains the queue */
+static int test_applied_at_block_start(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    api->set_param(inst, "mix", "0.2");
+    api->set_param(inst, "tap1_pan", "1");
+    if (inst->smoothedMix.targetValue != 0.5f) {
+        fprintf(stderr, "set_param touched audio state directly\n");
+        return 1;
+    }
+    int16_t block[128 * 2] = {0};
+    api->process_block(inst, block, 128);
+    float gainL, gainR;
+    DelayTap_PanGains(&inst->taps[0], &gainL, &gainR);
+    if (inst->smoothedMix.targetValue != 0.2f || inst->taps[0].smoothedGainR.targetValue != gainR) {
+        fprintf(stderr, "queued changes not applied: mix target %g\n", inst->smoothedMix.targetValue);
+        return 1;
+    }
+    api->destroy_instance(inst);
+    return 0;
+}
+
+/* Overflowing the ring falls back to replaying the latest event of every
+ * type and tap, synced heads included */
+static int test_overflow_resync(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    char val[16];
+    for (int k = 0; k < PARAM_QUEUE_SIZE * 2; k++) {
+        snprintf(val, sizeof(val), "%d", 20 + k);
+        api->set_param(inst, "time", val);
+    }
+    api->set_param(inst, "feedback", "0.8");
+    api->set_param(inst, "tap1_pan", "1");
+    api->set_param(inst, "tap1_division", "1/8");
+    if (!atomic_load(&inst->paramQueue.resync)) {
+        fprintf(stderr, "queue never overflowed\n");
+        return 1;
+    }
+    int16_t block[128 * 2] = {0};
+    api->process_block(inst, block, 128);
+    float gainL, gainR;
+    DelayTap_PanGains(&inst->taps[0], &gainL, &gainR);
+    if (inst->smoothedDelayTime.targetValue != GetDelayTimeSeconds(20 + PARAM_QUEUE_SIZE * 2 - 1) ||
+        inst->smoothedFeedback.targetValue != GetFeedback(0.8f, 0.0f) ||
+        inst->taps[0].smoothedGainR.targetValue != gainR ||
+        inst->taps[0].smoothedTime.targetValue != compute_synced_time(120.0f, DIV_1_8) * 0.001f) {
+        fprintf(stderr, "resync lost the latest values (time %g, feedback %g, tap1 gain %g time %g)\n",
+                inst->smoothedDelayTime.targetValue, inst->smoothedFeedback.targetValue,
+                inst->taps[0].smoothedGainR.targetValue, inst->taps[0].smoothedTime.targetValue);
+        return 1;
+    }
+    api->destroy_instance(inst);
+    return 0;
+}
+
+typedef struct {
+    audio_fx_api_v2_t *api;
+    void *inst;
+} producer_args_t;
+
+static void *producer(void *arg) {
+    producer_args_t *p = (producer_args_t*)arg;
+    const char *tones[] = { "0.1", "0.9" };
+    for (int k = 0; k < 20000; k++) {
+        p->api->set_param(p->inst, "tone", tones[k & 1]);
+        p->api->set_param(p->inst, "tap2_gain", tones[(k + 1) & 1]);
+    }
+    p->api->set_param(p->inst, "tone", "0.3");
+    return NULL;
+}
+
+/* set_param on another thread while blocks are processed */
+static int test_concurrent_producer(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *inst = (spacecho_instance_t*)api->create_instance(NULL, "{}");
+    api->set_param(inst, "taps", "2");
+    producer_args_t args = { api, inst };
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, producer, &args) != 0) {
+        fprintf(stderr, "failed to start producer\n");
+        return 1;
+    }
+    int16_t block[128 * 2];
+    for (int k = 0; k < 2000; k++) {
+        for (int i = 0; i < 128 * 2; i++) block[i] = (int16_t)((i * 37 + k) % 2000 - 1000);
+        api->process_block(inst, block, 128);
+    }
+    pthread_join(thread, NULL);
+    api->process_block(inst, block, 128);
+    if (inst->smoothedTone.targetValue != 0.3f) {
+        fprintf(stderr, "final tone target %g after concurrent updates\n", inst->smoothedTone.targetValue);
+        return 1;
+    }
+    api->destroy_instance(inst);
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+
+    if (test_applied_at_block_start(api) != 0) return 1;
+    if (test_overflow_resync(api) != 0) return 1;
+    if (test_concurrent_producer(api) != 0) return 1;
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+static void configure(audio_fx_api_v2_t *api, void *inst) {
+    const char *keys[] = { "time", "feedback", "tone", "wow", "stereo_width", "quality", "bpm",
+                           "taps", "tap1_time", "tap2_division", "tap2_gain", "tap3_pan", "division" };
+    const char *vals[] = { "480", "0.62", "0.31", "0.4", "35", "hermite", "97",
+                           "3", "150", "1/16t", "0.45", "-0.7", "1/4d" };
+    for (int k = 0; k < 13; k++) api->set_param(inst, keys[k], vals[k]);
+}
+
+/* Keys in any order, with whitespace and unknown values, parse in one pass */
+static int test_json_tokenizer(void) {
+    const char *json = " { \"unknown\" : {\"nested\":[1,{\"x\":\"}\"}]}, \"tap1_gain\":0.25,"
+                       "\"taps\" : 2 ,\"division\":\"1/8t\",\"quality\":3,\"mix\":-1.5e-1,\"flag\":true }";
+    StateFields st;
+    if (state_parse_json(json, &st) != 0) {
+        fprintf(stderr, "tokenizer rejected valid state\n");
+        return 1;
+    }
+    uint64_t expect = (1ull << PARAM_TAPS) | (1ull << PARAM_DIVISION) | (1ull << PARAM_QUALITY) |
+                      (1ull << PARAM_MIX) | (1ull << (PARAM_TAP_FIRST + TAP_FIELD_GAIN));
+    if (st.present != expect || st.value[PARAM_DIVISION] != DIV_1_8T || st.value[PARAM_QUALITY] != 3.0f ||
+        fabsf(st.value[PARAM_MIX] + 0.15f) > 1e-6f || st.value[PARAM_TAP_FIRST + TAP_FIELD_GAIN] != 0.25f) {
+        fprintf(stderr, "tokenizer fields wrong (mask %llx)\n", (unsigned long long)st.present);
+        return 1;
+    }
+    if (state_parse_json("{\"time\":", &st) == 0 || state_parse_json("[1]", &st) == 0) {
+        fprintf(stderr, "tokenizer accepted malformed state\n");
+        return 1;
+    }
+    return 0;
+}
+
+/* JSON and blob restores land on the same state as the source */
+static int test_round_trips(audio_fx_api_v2_t *api) {
+    void *src = api->create_instance(NULL, "{}");
+    void *from_json = api->create_instance(NULL, "{}");
+    void *from_blob = api->create_instance(NULL, "{}");
+    void *from_state_key = api->create_instance(NULL, "{}");
+    configure(api, src);
+
+    char json[2048], blob[STATE_BLOB_TEXT_MAX];
+    if (api->get_param(src, "state", json, sizeof(json)) < 0 ||
+        api->get_param(src, "state_blob", blob, sizeof(blob)) < 0) {
+        fprintf(stderr, "state did not fit\n");
+        return 1;
+    }
+    api->set_param(from_json, "state", json);
+    api->set_param(from_blob, "state_blob", blob);
+    api->set_param(from_state_key, "state", blob);
+
+    char a[2048], b[2048], c[2048];
+    api->get_param(from_json, "state", a, sizeof(a));
+    api->get_param(from_blob, "state", b, sizeof(b));
+    api->get_param(from_state_key, "state", c, sizeof(c));
+    int ok = strcmp(json, a) == 0 && strcmp(json, b) == 0 && strcmp(json, c) == 0;
+    if (!ok) fprintf(stderr, "state round trip differs:\n%s\n%s\n%s\n%s\n", json, a, b, c);
+
+    /* A corrupted blob must leave the instance untouched */
+    blob[0] = blob[0] == 'A' ? 'B' : 'A';
+    api->set_param(from_blob, "state_blob", blob);
+    api->set_param(from_blob, "state", "not a state");
+    api->get_param(from_blob, "state", b, sizeof(b));
+    if (strcmp(json, b) != 0) {
+        fprintf(stderr, "corrupt blob changed state: %s\n", b);
+        ok = 0;
+    }
+
+    api->destroy_instance(src);
+    api->destroy_instance(from_json);
+    api->destroy_instance(from_blob);
+    api->destroy_instance(from_state_key);
+    return ok ? 0 : 1;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+
+    if (test_json_tokenizer() != 0) return 1;
+    if (test_round_trips(api) != 0) return 1;
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+static void *create_with_storage(audio_fx_api_v2_t *api, const char *storage) {
+    char config[64];
+    snprintf(config, sizeof(config), "{\"delay_storage\":\"%s\"}", storage);
+    return api->create_instance(NULL, config);
+}
+
+/* Compact storage halves the delay buffer; unknown names fall back to float */
+static int test_footprint(audio_fx_api_v2_t *api) {
+    spacecho_instance_t *f = (spacecho_instance_t*)create_with_storage(api, "float");
+    spacecho_instance_t *i16 = (spacecho_instance_t*)create_with_storage(api, "int16");
+    spacecho_instance_t *bf = (spacecho_instance_t*)create_with_storage(api, "bf16");
+    spacecho_instance_t *bad = (spacecho_instance_t*)create_with_storage(api, "double");
+    size_t floatBytes = f->delayGrowth.current.size;
+    int ok = i16->delayLine.storage == DELAY_STORAGE_INT16 && i16->delayGrowth.current.size == floatBytes / 2 &&
+             bf->delayLine.storage == DELAY_STORAGE_BF16 && bf->delayGrowth.current.size == floatBytes / 2 &&
+             bad->delayLine.storage == DELAY_STORAGE_FLOAT && bad->delayLine.packed == NULL;
+    api->destroy_instance(f);
+    api->destroy_instance(i16);
+    api->destroy_instance(bf);
+    api->destroy_instance(bad);
+    if (!ok) {
+        fprintf(stderr, "compact storage did not halve the %zu byte delay buffer\n", floatBytes);
+        return 1;
+    }
+    return 0;
+}
+
+/* Runs a feedback tail (with a time change that grows the buffer) through a
+ * float instance, a compact block-kernel instance and a compact reference
+ * instance; reports the compact kernel's error against float and against the
+ * compact reference */
+static void run_storage_case(audio_fx_api_v2_t *api, const char *storage, const char *quality,
+                             int *vs_float, int *vs_reference) {
+    char config[64];
+    snprintf(config, sizeof(config), "{\"delay_storage\":\"%s\"}", storage);
+    RefPair pair;
+    RefPair_Open(&pair, api, config);
+    void *flt = create_with_storage(api, "float");
+    const char *keys[] = { "feedback", "mix", "tone", "quality" };
+    const char *vals[] = { "0.7", "0.7", "0.6", quality };
+    RefPair_SetList(&pair, keys, vals, 4);
+    test_set_params(api, flt, keys, vals, 4);
+
+    int16_t c[128 * 2];
+    *vs_float = *vs_reference = 0;
+    for (int n = 0; n < 1500; n++) {
+        if (n == 700) {
+            RefPair_Set(&pair, "time", "1100");
+            api->set_param(flt, "time", "1100");
+        }
+        for (int i = 0; i < 256; i++) c[i] = pair.in[i] = (n < 200) ? noise_sample() : 0;
+        int dr = RefPair_Run(&pair, 128);
+        api->process_block(flt, c, 128);
+        if (n < 700 && dr > *vs_reference) *vs_reference = dr;  /* time ramps differ afterwards */
+        for (int i = 0; i < 256; i++) {
+            int df = abs((int)c[i] - (int)pair.blkOut[i]);
+            if (df > *vs_float) *vs_float = df;
+        }
+    }
+    RefPair_Close(&pair);
+    api->destroy_instance(flt);
+}
+
+/* int16 keeps ~-90dB of quantization noise, bf16 an 8-bit mantissa; both
+ * kernels quantize the same way */
+static int test_error_bounds(audio_fx_api_v2_t *api) {
+    const char *storages[] = { "int16", "bf16" };
+    const int floatBound[] = { 4, 48 };
+    const char *qualities[] = { "linear", "hermite", "allpass", "sinc" };
+    for (int s = 0; s < 2; s++) {
+        for (int q = 0; q < 4; q++) {
+            int vsFloat, vsReference;
+            run_storage_case(api, storages[s], qualities[q], &vsFloat, &vsReference);
+            if (vsFloat > floatBound[s] || vsReference > 1) {
+                fprintf(stderr, "%s/%s: %d LSB from float storage, %d LSB from the reference kernel\n",
+                        storages[s], qualities[q], vsFloat, vsReference);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(4242u);
+
+    if (test_footprint(api) != 0) return 1;
+    if (test_error_bounds(api) != 0) return 1;
+    return 0;
+}
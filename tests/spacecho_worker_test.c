@@ -0,0 +1,94 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+#include "../src/dsp/spacecho.c"
+#include "spacecho_test_util.h"
+
+/* Let the worker finish everything queued, so the test never under-runs */
+static void wait_for_worker(spacecho_instance_t *inst) {
+    for (int s = 0; s < 2; s++) {
+        while (atomic_load(&inst->worker.slots[s].state) == WORKER_SLOT_QUEUED) sched_yield();
+    }
+}
+
+/* Offloaded output is the inline output one block later, including
+ * parameter changes and MIDI clock driven synced-time updates */
+static int test_matches_inline(audio_fx_api_v2_t *api) {
+    void *plain = api->create_instance(NULL, "{}");
+    spacecho_instance_t *off = (spacecho_instance_t*)api->create_instance(NULL, "{\"worker_thread\":true}");
+    if (!plain || !off || !off->worker.running) {
+        fprintf(stderr, "failed to create offloaded instance\n");
+        return 1;
+    }
+
+    char latency[16];
+    api->get_param(off, "latency", latency, sizeof(latency));
+    if (strcmp(latency, "128") != 0) {
+        fprintf(stderr, "offloaded latency %s, expected 128\n", latency);
+        return 1;
+    }
+    api->get_param(plain, "latency", latency, sizeof(latency));
+    if (strcmp(latency, "0") != 0) {
+        fprintf(stderr, "inline latency %s, expected 0\n", latency);
+        return 1;
+    }
+
+    const char *keys[] = { "feedback", "mix", "quality", "taps", "tap1_time", "division" };
+    const char *vals[] = { "0.8", "0.6", "sinc", "2", "170", "1/8" };
+    test_set_params(api, plain, keys, vals, 6);
+    test_set_params(api, off, keys, vals, 6);
+
+    const int block_frames = 128;
+    int16_t a[128 * 2], b[128 * 2], prev[128 * 2] = {0};
+    const uint8_t tick = 0xF8;
+    double next_tick = 0.0;
+    const double tick_frames = 44100.0 * 60.0 / (100.0 * 24.0);  /* 100 BPM */
+    int mismatches = 0;
+    for (int blk = 0; blk < 1500; blk++) {
+        if (blk == 600) {
+            api->set_param(plain, "tone", "0.9");
+            api->set_param(off, "tone", "0.9");
+        }
+        for (; next_tick < (blk + 1) * block_frames; next_tick += tick_frames) {
+            int offset = (int)next_tick - blk * block_frames;
+            move_audio_fx_on_midi_at(plain, &tick, 1, 0, offset);
+            move_audio_fx_on_midi_at(off, &tick, 1, 0, offset);
+        }
+        for (int i = 0; i < block_frames * 2; i++) {
+            a[i] = (blk < 200) ? noise_sample() : 0;
+            b[i] = a[i];
+        }
+        api->process_block(plain, a, block_frames);
+        api->process_block(off, b, block_frames);
+        wait_for_worker(off);
+        if (memcmp(b, prev, sizeof(b)) != 0) mismatches++;
+        memcpy(prev, a, sizeof(a));
+    }
+
+    char time_plain[16], time_off[16];
+    api->get_param(plain, "time", time_plain, sizeof(time_plain));
+    api->get_param(off, "time", time_off, sizeof(time_off));
+    uint32_t xruns = off->worker.xruns;
+    api->destroy_instance(plain);
+    api->destroy_instance(off);
+
+    if (mismatches || xruns || strcmp(time_plain, time_off) != 0 || strcmp(time_off, "300") != 0) {
+        fprintf(stderr, "offload: %d mismatched blocks, %u xruns, time %s vs %s\n",
+                mismatches, xruns, time_plain, time_off);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    host_api_v1_t host = {0};
+    audio_fx_api_v2_t *api = test_init(&host);
+    if (!api) return 1;
+    noise_seed(4242u);
+
+    if (test_matches_inline(api) != 0) return 1;
+    return 0;
+}